@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <array>                  // for array
+#include <cstddef>                // for byte, size_t
+#include <memory_resource>        // for monotonic_buffer_resource
+#include <sphere_n/cylind_n.hpp>  // for CylindN
+#include <sphere_n/sphere_n.hpp>  // for SphereN, PRIME_TABLE
+#include <span>                   // for span
+#include <vector>                 // for vector
+
+/**
+ * @brief Bases for an S^n generator taken from the prime table
+ *
+ * @param n Number of bases
+ * @return std::vector<unsigned long>
+ */
+static auto primes(size_t n) -> std::vector<unsigned long> {
+    return {std::begin(lds2::PRIME_TABLE), std::begin(lds2::PRIME_TABLE) + n};
+}
+
+/** @brief Number of points drawn from each short-lived generator */
+static constexpr size_t SHORT_SEQ = 8;
+
+/**
+ * @brief Construct, use and drop a SphereN with the default heap allocator
+ */
+static void SphereN_heap(benchmark::State& state) {
+    const auto base = primes(static_cast<size_t>(state.range(0)));
+    std::vector<double> res(base.size() + 1);
+    for (auto _ : state) {
+        auto sgen = lds2::SphereN(base);
+        for (auto i = 0U; i != SHORT_SEQ; ++i) {
+            sgen.pop_into(res);
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Construct, use and drop a SphereN allocated from a monotonic arena
+ *
+ * The arena is rewound with `release()` after each generator, so the whole
+ * generator tree is freed in O(1).
+ */
+static void SphereN_arena(benchmark::State& state) {
+    const auto base = primes(static_cast<size_t>(state.range(0)));
+    std::vector<double> res(base.size() + 1);
+    std::array<std::byte, 16384> buffer{};
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    for (auto _ : state) {
+        {
+            auto sgen = lds2::SphereN(base, &arena);
+            for (auto i = 0U; i != SHORT_SEQ; ++i) {
+                sgen.pop_into(res);
+            }
+            benchmark::DoNotOptimize(res.data());
+        }
+        arena.release();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Construct, use and drop a CylindN with the default heap allocator
+ */
+static void CylindN_heap(benchmark::State& state) {
+    const auto base = primes(static_cast<size_t>(state.range(0)));
+    std::vector<double> res(base.size() + 1);
+    for (auto _ : state) {
+        auto cgen = lds2::CylindN(base);
+        for (auto i = 0U; i != SHORT_SEQ; ++i) {
+            cgen.pop_into(res);
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Construct, use and drop a CylindN allocated from a monotonic arena
+ */
+static void CylindN_arena(benchmark::State& state) {
+    const auto base = primes(static_cast<size_t>(state.range(0)));
+    std::vector<double> res(base.size() + 1);
+    std::array<std::byte, 16384> buffer{};
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    for (auto _ : state) {
+        {
+            auto cgen = lds2::CylindN(base, &arena);
+            for (auto i = 0U; i != SHORT_SEQ; ++i) {
+                cgen.pop_into(res);
+            }
+            benchmark::DoNotOptimize(res.data());
+        }
+        arena.release();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(SphereN_heap)->Arg(4)->Arg(8)->Arg(32);
+BENCHMARK(SphereN_arena)->Arg(4)->Arg(8)->Arg(32);
+BENCHMARK(CylindN_heap)->Arg(4)->Arg(8)->Arg(32);
+BENCHMARK(CylindN_arena)->Arg(4)->Arg(8)->Arg(32);
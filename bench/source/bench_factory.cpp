@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <cstddef>                // for size_t
+#include <sphere_n/factory.hpp>   // for make_generator, GeneratorKind, GeneratorOptions
+#include <sphere_n/halton_n.hpp>  // for HaltonN
+#include <sphere_n/sphere_n.hpp>  // for map_sphere_n, select_map_kernel, detect_isa
+#include <vector>                 // for vector
+
+/** @brief Points per benchmark iteration */
+static constexpr size_t N_POINTS_PER_ITER = 1024;
+
+/**
+ * @brief Map kernels on the same input; range(0) is m, range(1) selects the kernel
+ *
+ * 0: `map_sphere_n()` with a runtime m, 1: the kernel fixed for m in the
+ * generic Isa, 2: the kernel of `detect_isa()`.
+ */
+static void Map_kernel(benchmark::State& state) {
+    const auto m = static_cast<size_t>(state.range(0));
+    auto halton = lds2::HaltonN(m);
+    std::vector<double> u(N_POINTS_PER_ITER * m);
+    halton.pop_batch(u);
+    std::vector<double> x(N_POINTS_PER_ITER * (m + 1));
+    const auto kernel
+        = (state.range(1) == 0) ? lds2::MapKernel{&lds2::map_sphere_n}
+          : (state.range(1) == 1) ? lds2::select_map_kernel(m, lds2::Isa::generic)
+                                  : lds2::select_map_kernel(m, lds2::detect_isa());
+    for (auto _ : state) {
+        kernel(m, u, x, lds2::Inversion::interp, lds2::Accuracy::high);
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+}
+
+/**
+ * @brief Type-erased generator from make_generator(); range(0) is dim, range(1) the batch
+ */
+static void Factory_generator(benchmark::State& state) {
+    const auto dim = static_cast<size_t>(state.range(0));
+    const auto batch = static_cast<size_t>(state.range(1));
+    auto opts = lds2::GeneratorOptions{};
+    opts.accuracy = lds2::Accuracy::high;
+    auto gen = lds2::make_generator(lds2::GeneratorKind::sphere, dim, opts);
+    std::vector<double> x(batch * dim);
+    for (auto _ : state) {
+        for (auto k = size_t{0}; k < N_POINTS_PER_ITER; k += batch) {
+            gen.pop_batch(x);
+        }
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+    state.SetLabel(gen.name());
+}
+
+BENCHMARK(Map_kernel)
+    ->ArgNames({"m", "kernel"})
+    ->Args({4, 0})
+    ->Args({4, 1})
+    ->Args({4, 2})
+    ->Args({8, 0})
+    ->Args({8, 1})
+    ->Args({8, 2})
+    ->Args({16, 0})
+    ->Args({16, 2});
+BENCHMARK(Factory_generator)->ArgNames({"dim", "batch"})->Args({5, 1})->Args({5, 256});
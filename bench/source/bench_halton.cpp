@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <cstddef>                // for size_t
+#include <ldsgen/lds.hpp>         // for VdCorput
+#include <sphere_n/halton_n.hpp>  // for HaltonN
+#include <sphere_n/sphere_n.hpp>  // for PRIME_TABLE
+#include <vector>                 // for vector
+
+/** @brief Points per benchmark iteration */
+static constexpr size_t N_POINTS_PER_ITER = 1024;
+
+/**
+ * @brief One VdCorput per coordinate, the baseline; range(0) is the dimension
+ */
+static void Halton_vdcorput(benchmark::State& state) {
+    const auto dim = static_cast<size_t>(state.range(0));
+    std::vector<lds2::VdCorput> vdcs;
+    for (auto d = 0U; d != dim; ++d) {
+        vdcs.emplace_back(lds2::PRIME_TABLE[d]);
+    }
+    std::vector<double> res(N_POINTS_PER_ITER * dim);
+    for (auto _ : state) {
+        for (auto i = 0U; i != N_POINTS_PER_ITER; ++i) {
+            for (auto d = 0U; d != dim; ++d) {
+                res[i * dim + d] = vdcs[d].pop();
+            }
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+}
+
+/**
+ * @brief HaltonN::pop_batch, row-major; range(0) is the dimension
+ */
+static void HaltonN_batch(benchmark::State& state) {
+    auto hgen = lds2::HaltonN(static_cast<size_t>(state.range(0)));
+    std::vector<double> res(N_POINTS_PER_ITER * hgen.size());
+    for (auto _ : state) {
+        hgen.pop_batch(res);
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+}
+
+/**
+ * @brief HaltonN::pop_soa, coordinate-major; range(0) is the dimension
+ */
+static void HaltonN_soa(benchmark::State& state) {
+    auto hgen = lds2::HaltonN(static_cast<size_t>(state.range(0)));
+    std::vector<double> res(N_POINTS_PER_ITER * hgen.size());
+    for (auto _ : state) {
+        hgen.pop_soa(res);
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+}
+
+BENCHMARK(Halton_vdcorput)->Arg(4)->Arg(32);
+BENCHMARK(HaltonN_batch)->Arg(4)->Arg(32);
+BENCHMARK(HaltonN_soa)->Arg(4)->Arg(32);
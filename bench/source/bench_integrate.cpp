@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <cmath>                   // for exp
+#include <cstddef>                 // for size_t
+#include <span>                    // for span
+#include <sphere_n/integrate.hpp>  // for integrate, IntegrateOptions
+#include <sphere_n/sphere_n.hpp>   // for SphereN, PRIME_TABLE
+#include <vector>                  // for vector
+
+/** @brief Points per benchmark iteration */
+static constexpr size_t N_POINTS_PER_ITER = size_t{1} << 18;
+
+/** @brief The integrand */
+static auto integrand(std::span<const double> x) -> double { return std::exp(x[0] - x[1]); }
+
+/**
+ * @brief Baseline: store all points of SphereN, then average; range(0) is the number of bases
+ */
+static void Integrate_materialized(benchmark::State& state) {
+    const auto m = static_cast<size_t>(state.range(0));
+    const auto base = std::span<const unsigned long>(lds2::PRIME_TABLE, m);
+    std::vector<double> pts(N_POINTS_PER_ITER * (m + 1));
+    for (auto _ : state) {
+        auto gen = lds2::SphereN(base);
+        for (auto k = size_t{0}; k != N_POINTS_PER_ITER; ++k) {
+            gen.pop_into(std::span<double>(pts).subspan(k * (m + 1), m + 1));
+        }
+        auto sum = 0.0;
+        for (auto k = size_t{0}; k != N_POINTS_PER_ITER; ++k) {
+            sum += integrand(std::span<const double>(pts).subspan(k * (m + 1), m + 1));
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+}
+
+/**
+ * @brief Fused driver; range(0) is the number of bases, range(1) the threads
+ */
+static void Integrate_fused(benchmark::State& state) {
+    const auto m = static_cast<size_t>(state.range(0));
+    const auto base = std::span<const unsigned long>(lds2::PRIME_TABLE, m);
+    auto opts = lds2::IntegrateOptions{};
+    opts.threads = static_cast<size_t>(state.range(1));
+    for (auto _ : state) {
+        const auto est = lds2::integrate(integrand, base, N_POINTS_PER_ITER, opts);
+        benchmark::DoNotOptimize(est.mean);
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+}
+
+BENCHMARK(Integrate_materialized)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(Integrate_fused)
+    ->Args({4, 1})
+    ->Args({8, 1})
+    ->Args({4, 0})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
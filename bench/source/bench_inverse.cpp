@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <cstddef>                       // for size_t
+#include <span>                          // for span
+#include <sphere_n/cylind_n.hpp>         // for map_cylind_n, inverse_cylind_n
+#include <sphere_n/radical_inverse.hpp>  // for radical_inverse, cell_ids
+#include <sphere_n/sphere_n.hpp>         // for map_sphere_n, inverse_sphere_n, PRIME_TABLE
+#include <vector>                        // for vector
+
+/** @brief Points per benchmark iteration */
+static constexpr size_t N_POINTS_PER_ITER = 4096;
+
+/**
+ * @brief Halton values of the first n points on the first m primes, row-major
+ */
+static auto make_values(size_t m, size_t n) -> std::vector<double> {
+    std::vector<double> res(n * m);
+    for (auto k = size_t{0}; k != n; ++k) {
+        for (auto i = size_t{0}; i != m; ++i) {
+            res[k * m + i] = lds2::radical_inverse(k + 1, lds2::PRIME_TABLE[i]);
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief Batch inverse of the SphereN mapping; range(0) is m, range(1) the Inversion
+ */
+static void Inverse_sphere_n(benchmark::State& state) {
+    const auto m = static_cast<size_t>(state.range(0));
+    const auto mode = static_cast<lds2::Inversion>(state.range(1));
+    state.SetLabel(mode == lds2::Inversion::interp ? "interp" : "newton");
+    std::vector<double> x(N_POINTS_PER_ITER * (m + 1));
+    lds2::map_sphere_n(m, make_values(m, N_POINTS_PER_ITER), x, mode);
+    std::vector<double> u(N_POINTS_PER_ITER * m);
+    for (auto _ : state) {
+        lds2::inverse_sphere_n(m, x, u, mode);
+        benchmark::DoNotOptimize(u.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+}
+
+/**
+ * @brief Batch inverse of the CylindN mapping; range(0) is m
+ */
+static void Inverse_cylind_n(benchmark::State& state) {
+    const auto m = static_cast<size_t>(state.range(0));
+    std::vector<double> x(N_POINTS_PER_ITER * (m + 1));
+    lds2::map_cylind_n(m, make_values(m, N_POINTS_PER_ITER), x);
+    std::vector<double> u(N_POINTS_PER_ITER * m);
+    for (auto _ : state) {
+        lds2::inverse_cylind_n(m, x, u);
+        benchmark::DoNotOptimize(u.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+}
+
+/**
+ * @brief Points to stratum cell IDs, inverse included; range(0) is m
+ *
+ * Coordinate d is cut into PRIME_TABLE[d] strata, the elementary cells of
+ * the first prod PRIME_TABLE[d] points.
+ */
+static void Cell_ids(benchmark::State& state) {
+    const auto m = static_cast<size_t>(state.range(0));
+    std::vector<double> x(N_POINTS_PER_ITER * (m + 1));
+    lds2::map_sphere_n(m, make_values(m, N_POINTS_PER_ITER), x);
+    const auto strata = std::span<const unsigned long>(lds2::PRIME_TABLE, m);
+    std::vector<double> u(N_POINTS_PER_ITER * m);
+    std::vector<unsigned long> ids(N_POINTS_PER_ITER);
+    for (auto _ : state) {
+        lds2::inverse_sphere_n(m, x, u);
+        lds2::cell_ids(u, strata, ids);
+        benchmark::DoNotOptimize(ids.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+}
+
+BENCHMARK(Inverse_sphere_n)->ArgsProduct({{4, 8, 16}, {0, 1}});
+BENCHMARK(Inverse_cylind_n)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK(Cell_ids)->Arg(4)->Arg(8);
@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK, Counter
+
+#include <algorithm>                     // for max
+#include <cmath>                         // for abs
+#include <cstddef>                       // for size_t
+#include <numbers>                       // for pi
+#include <sphere_n/radical_inverse.hpp>  // for radical_inverse
+#include <sphere_n/sphere_n.hpp>         // for tp_inverse, tp_value, Inversion
+
+/** @brief Inversions per benchmark iteration */
+static constexpr long N_VALUES_PER_ITER = 1024;
+
+/**
+ * @brief Largest CDF residual |F(xi) - u| over the first values of the sequence
+ */
+static auto max_residual(size_t n, lds2::Inversion mode) -> double {
+    const auto t0 = lds2::tp_value(n, 0.0);
+    const auto dt = lds2::tp_value(n, std::numbers::pi) - t0;
+    auto res = 0.0;
+    for (auto k = 1UL; k <= 4096UL; ++k) {
+        const auto u = lds2::radical_inverse(k, 2);
+        const auto xi = lds2::tp_inverse(n, u, mode);
+        res = std::max(res, std::abs((lds2::tp_value(n, xi) - t0) / dt - u));
+    }
+    return res;
+}
+
+/**
+ * @brief Throughput of the Tp inversion; range(0) is n, range(1) the Inversion
+ */
+static void TpInverse(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto mode = static_cast<lds2::Inversion>(state.range(1));
+    state.SetLabel(mode == lds2::Inversion::interp ? "interp" : "newton");
+    auto k = 0UL;
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (auto i = 0; i != N_VALUES_PER_ITER; ++i) {
+            sum += lds2::tp_inverse(n, lds2::radical_inverse(++k, 2), mode);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * N_VALUES_PER_ITER);
+    state.counters["max_residual"] = max_residual(n, mode);
+}
+
+BENCHMARK(TpInverse)->ArgsProduct({{2, 4, 16}, {0, 1}});
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <algorithm>              // for copy
+#include <cstddef>                // for size_t
+#include <span>                   // for span
+#include <sphere_n/sphere_n.hpp>  // for SphereN, Sphere3, PRIME_TABLE
+#include <vector>                 // for vector
+
+/**
+ * @brief Points on S^2 ... S^m from one generator per dimension, the baseline; range(0) is m
+ */
+static void Sweep_separate(benchmark::State& state) {
+    const auto m = static_cast<size_t>(state.range(0));
+    const auto bases = std::span<const unsigned long>(lds2::PRIME_TABLE, m);
+    auto s2 = lds2::Sphere(bases[m - 2], bases[m - 1]);
+    auto s3 = lds2::Sphere3(bases.last(3));
+    std::vector<lds2::SphereN> gens;
+    for (auto k = size_t{4}; k <= m; ++k) {
+        gens.emplace_back(bases.last(k));
+    }
+    std::vector<std::vector<double>> levels;
+    for (auto k = size_t{2}; k <= m; ++k) {
+        levels.emplace_back(k + 1);
+    }
+    for (auto _ : state) {
+        const auto p2 = s2.pop();
+        std::copy(p2.begin(), p2.end(), levels[0].begin());
+        s3.pop_into(levels[1]);
+        for (auto j = size_t{0}; j != gens.size(); ++j) {
+            gens[j].pop_into(levels[j + 2]);
+        }
+        benchmark::DoNotOptimize(levels.back().data());
+    }
+}
+
+/**
+ * @brief The same points from SphereN::pop_nested; range(0) is m
+ */
+static void Sweep_nested(benchmark::State& state) {
+    const auto m = static_cast<size_t>(state.range(0));
+    auto sgen = lds2::SphereN(std::span<const unsigned long>(lds2::PRIME_TABLE, m));
+    std::vector<std::vector<double>> levels;
+    std::vector<std::span<double>> views;
+    for (auto j = size_t{0}; j != sgen.levels(); ++j) {
+        levels.emplace_back(j + 3);
+    }
+    for (auto& level : levels) {
+        views.emplace_back(level);
+    }
+    for (auto _ : state) {
+        sgen.pop_nested(views);
+        benchmark::DoNotOptimize(levels.back().data());
+    }
+}
+
+BENCHMARK(Sweep_separate)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK(Sweep_nested)->Arg(4)->Arg(8)->Arg(16);
@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <cstddef>                // for size_t
+#include <span>                   // for span
+#include <sphere_n/numa.hpp>      // for generate_bulk, BulkOptions, numa_topology
+#include <sphere_n/sphere_n.hpp>  // for PRIME_TABLE
+
+/** @brief Points per benchmark iteration, 40 MB of output on S^4 */
+static constexpr size_t N_POINTS_PER_ITER = size_t{1} << 20;
+
+/**
+ * @brief Bulk generation including the allocation and placement of the output
+ *
+ * range(0) is the number of bases, range(1) selects `numa_aware`; the
+ * threads are all usable CPUs. On a single-node machine both variants
+ * place every page on the same node and differ only in pinning, static
+ * versus dynamic slicing and the zero-fill of the naive output.
+ */
+static void Bulk_generate(benchmark::State& state) {
+    const auto m = static_cast<size_t>(state.range(0));
+    const auto base = std::span<const unsigned long>(lds2::PRIME_TABLE, m);
+    auto opts = lds2::BulkOptions{};
+    opts.numa_aware = state.range(1) != 0;
+    for (auto _ : state) {
+        const auto pts = lds2::generate_bulk(base, N_POINTS_PER_ITER, opts);
+        benchmark::DoNotOptimize(pts.points().data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+    state.counters["nodes"] = static_cast<double>(lds2::numa_topology().size());
+}
+
+BENCHMARK(Bulk_generate)
+    ->ArgNames({"m", "numa"})
+    ->Args({4, 0})
+    ->Args({4, 1})
+    ->Args({8, 0})
+    ->Args({8, 1})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <cstddef>                // for size_t
+#include <sphere_n/prefetch.hpp>  // for Prefetcher, PrefetchOptions, WaitPolicy
+#include <sphere_n/sphere_n.hpp>  // for SphereN
+#include <vector>                 // for vector
+
+/** @brief Bases of the generators, points on S^4 */
+static const unsigned long BASE[] = {2, 3, 5, 7};
+
+/**
+ * @brief Baseline: SphereN::pop_into() inline in the consumer loop
+ */
+static void Prefetch_inline(benchmark::State& state) {
+    auto gen = lds2::SphereN(BASE);
+    std::vector<double> x(5);
+    for (auto _ : state) {
+        gen.pop_into(x);
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+/**
+ * @brief Prefetcher::next(); range(0) is the depth, range(1) the WaitPolicy
+ *
+ * The consumer only sees the cost of `next()` while the producer keeps
+ * ahead; with fewer cores than threads the two alternate and the stalls
+ * counter shows how often the consumer had to wait.
+ */
+static void Prefetch_next(benchmark::State& state) {
+    auto opts = lds2::PrefetchOptions{};
+    opts.depth = static_cast<size_t>(state.range(0));
+    opts.wait = static_cast<lds2::WaitPolicy>(state.range(1));
+    auto pre = lds2::Prefetcher(BASE, opts);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pre.next().data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations()));
+    state.counters["stalls/point"] = static_cast<double>(pre.stalls())
+                                     / static_cast<double>(state.iterations());
+}
+
+BENCHMARK(Prefetch_inline);
+BENCHMARK(Prefetch_next)
+    ->ArgNames({"depth", "wait"})
+    ->Args({8, static_cast<long>(lds2::WaitPolicy::yield)})
+    ->Args({64, static_cast<long>(lds2::WaitPolicy::yield)})
+    ->Args({8, static_cast<long>(lds2::WaitPolicy::park)})
+    ->UseRealTime();
@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <cstddef>                // for size_t
+#include <span>                   // for span
+#include <sphere_n/cylind_n.hpp>  // for CylindN
+#include <sphere_n/quality.hpp>   // for measure_quality, QualityOptions
+#include <sphere_n/sphere_n.hpp>  // for SphereN, PRIME_TABLE
+#include <vector>                 // for vector
+
+/**
+ * @brief The first n points of a generator on the first primes, row-major
+ *
+ * @tparam Gen SphereN or CylindN
+ * @param n_bases Number of bases
+ * @param n Number of points
+ */
+template <typename Gen> static auto make_points(size_t n_bases, size_t n) -> std::vector<double> {
+    auto gen = Gen(std::span<const unsigned long>(lds2::PRIME_TABLE, n_bases));
+    std::vector<double> res(n * gen.size());
+    for (auto i = size_t{0}; i != n; ++i) {
+        gen.pop_into(std::span<double>(res).subspan(i * gen.size(), gen.size()));
+    }
+    return res;
+}
+
+/**
+ * @brief All quality metrics; range(0) is the number of bases, range(1) the number of points
+ *
+ * The metrics are reported as counters next to the timing, so a change of
+ * bases or kernels shows its effect on quality and speed in one run.
+ */
+template <typename Gen> static void Quality(benchmark::State& state) {
+    const auto n_bases = static_cast<size_t>(state.range(0));
+    const auto n = static_cast<size_t>(state.range(1));
+    const auto pts = make_points<Gen>(n_bases, n);
+    const auto dim = pts.size() / n;
+    auto report = lds2::QualityReport{};
+    for (auto _ : state) {
+        report = lds2::measure_quality(pts, dim, lds2::QualityOptions{});
+        benchmark::DoNotOptimize(report);
+    }
+    const auto nd = static_cast<double>(n);
+    state.counters["cap_disc"] = report.cap_discrepancy;
+    state.counters["energy/N2"] = report.riesz_energy / (nd * nd);
+    state.counters["min_dist"] = report.min_distance;
+    state.counters["cover"] = report.covering_radius;
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * n));
+}
+
+/**
+ * @brief Exact minimum distance alone, the cell-grid part; same ranges
+ */
+static void Quality_min_distance(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(1));
+    const auto pts = make_points<lds2::SphereN>(static_cast<size_t>(state.range(0)), n);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lds2::min_distance(pts, pts.size() / n));
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * n));
+}
+
+BENCHMARK(Quality<lds2::SphereN>)
+    ->Args({4, 4096})
+    ->Args({4, 16384})
+    ->Args({6, 16384})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(Quality<lds2::CylindN>)
+    ->Args({4, 4096})
+    ->Args({4, 16384})
+    ->Args({6, 16384})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(Quality_min_distance)
+    ->Args({4, 100000})
+    ->Args({6, 100000})
+    ->Unit(benchmark::kMillisecond);
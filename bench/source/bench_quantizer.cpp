@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <cstddef>                 // for size_t
+#include <span>                    // for span
+#include <sphere_n/quantizer.hpp>  // for SphereQuantizer
+#include <sphere_n/sphere_n.hpp>   // for SphereN, PRIME_TABLE
+#include <vector>                  // for vector
+
+/** @brief Queries per benchmark iteration */
+static constexpr size_t N_QUERIES = 1024;
+
+/** @brief Bases of the codebook (S^4, 5 coordinates) */
+static const unsigned long CODE_BASE[] = {2, 3, 5, 7};
+
+/**
+ * @brief Query vectors from a differently based sequence
+ */
+static auto make_queries() -> std::vector<double> {
+    const unsigned long qbase[] = {5, 3, 2, 7};
+    auto qgen = lds2::SphereN(qbase);
+    std::vector<double> res(N_QUERIES * qgen.size());
+    for (auto i = size_t{0}; i != N_QUERIES; ++i) {
+        qgen.pop_into(std::span<double>(res).subspan(i * qgen.size(), qgen.size()));
+    }
+    return res;
+}
+
+/**
+ * @brief Brute-force maximum dot product, the baseline; range(0) is the codebook size
+ */
+static void Quantizer_brute(benchmark::State& state) {
+    const auto m = static_cast<size_t>(state.range(0));
+    auto sgen = lds2::SphereN(CODE_BASE);
+    const auto dim = sgen.size();
+    std::vector<double> code(m * dim);
+    for (auto i = size_t{0}; i != m; ++i) {
+        sgen.pop_into(std::span<double>(code).subspan(i * dim, dim));
+    }
+    const auto queries = make_queries();
+    std::vector<size_t> res(N_QUERIES);
+    for (auto _ : state) {
+        for (auto q = size_t{0}; q != N_QUERIES; ++q) {
+            auto best = -2.0;
+            for (auto i = size_t{0}; i != m; ++i) {
+                auto dot = 0.0;
+                for (auto d = size_t{0}; d != dim; ++d) {
+                    dot += code[i * dim + d] * queries[q * dim + d];
+                }
+                if (dot > best) {
+                    best = dot;
+                    res[q] = i;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_QUERIES));
+}
+
+/**
+ * @brief SphereQuantizer::nearest_batch; range(0) is the codebook size
+ */
+static void Quantizer_tree(benchmark::State& state) {
+    auto sgen = lds2::SphereN(CODE_BASE);
+    auto quant = lds2::SphereQuantizer(sgen.size());
+    quant.grow(sgen, static_cast<size_t>(state.range(0)));
+    const auto queries = make_queries();
+    std::vector<size_t> res(N_QUERIES);
+    for (auto _ : state) {
+        quant.nearest_batch(queries, res);
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_QUERIES));
+}
+
+/**
+ * @brief Growing the codebook by range(0) points
+ */
+static void Quantizer_grow(benchmark::State& state) {
+    for (auto _ : state) {
+        auto sgen = lds2::SphereN(CODE_BASE);
+        auto quant = lds2::SphereQuantizer(sgen.size());
+        quant.grow(sgen, static_cast<size_t>(state.range(0)));
+        benchmark::DoNotOptimize(quant.size());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * state.range(0)));
+}
+
+BENCHMARK(Quantizer_brute)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+BENCHMARK(Quantizer_tree)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+BENCHMARK(Quantizer_grow)->Arg(1 << 16);
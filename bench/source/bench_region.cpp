@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <cmath>                  // for cos
+#include <cstddef>                // for size_t
+#include <numbers>                // for pi
+#include <span>                   // for span
+#include <sphere_n/region.hpp>    // for RegionN
+#include <sphere_n/sphere_n.hpp>  // for SphereN
+#include <vector>                 // for vector
+
+/** @brief Points in the cap per benchmark iteration */
+static constexpr size_t N_POINTS_PER_ITER = 1024;
+
+/** @brief Bases of the generators, points on S^4 */
+static const unsigned long BASE[] = {2, 3, 5, 7};
+
+/** @brief Pole of the cap */
+static const double POLE[] = {0, 0, 0, 0, 1};
+
+/**
+ * @brief Baseline: SphereN points with rejection; range(0) is the cap radius in degrees
+ */
+static void Region_reject(benchmark::State& state) {
+    const auto cos_theta = std::cos(static_cast<double>(state.range(0)) * std::numbers::pi / 180.0);
+    auto gen = lds2::SphereN(BASE);
+    std::vector<double> x(5);
+    auto tried = 0L;
+    for (auto _ : state) {
+        for (auto i = size_t{0}; i != N_POINTS_PER_ITER;) {
+            gen.pop_into(x);
+            ++tried;
+            i += (x[4] >= cos_theta) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+    state.counters["tried/point"] = static_cast<double>(tried)
+                                    / static_cast<double>(state.iterations() * N_POINTS_PER_ITER);
+}
+
+/**
+ * @brief RegionN batches in the same cap; range(0) is the cap radius in degrees
+ */
+static void Region_cap(benchmark::State& state) {
+    const auto theta = static_cast<double>(state.range(0)) * std::numbers::pi / 180.0;
+    auto gen = lds2::RegionN::cap(BASE, POLE, theta);
+    std::vector<double> res(N_POINTS_PER_ITER * 5);
+    for (auto _ : state) {
+        gen.pop_batch(res);
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_POINTS_PER_ITER));
+    state.counters["fraction"] = gen.fraction();
+}
+
+BENCHMARK(Region_reject)->Arg(90)->Arg(45)->Unit(benchmark::kMillisecond);
+BENCHMARK(Region_cap)->Arg(90)->Arg(45)->Arg(10)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <cstddef>                // for size_t
+#include <sphere_n/rotation.hpp>  // for Rotation3, quat_to_matrix
+#include <sphere_n/sphere_n.hpp>  // for Sphere3
+#include <vector>                 // for vector
+
+/** @brief Rotations per benchmark iteration */
+static constexpr size_t N_ROT_PER_ITER = 4096;
+
+/** @brief Bases of the rotation generators */
+static const unsigned long BASE[] = {2, 3, 5};
+
+/**
+ * @brief Baseline: Sphere3 points one at a time, as quaternions without the antipodal fold
+ */
+static void Rotation_sphere3_pop(benchmark::State& state) {
+    auto gen = lds2::Sphere3(BASE);
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (auto i = size_t{0}; i != N_ROT_PER_ITER; ++i) {
+            sum += gen.pop()[3];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_ROT_PER_ITER));
+}
+
+/**
+ * @brief Rotation3 quaternions one at a time
+ */
+static void Rotation_pop(benchmark::State& state) {
+    auto gen = lds2::Rotation3(BASE);
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (auto i = size_t{0}; i != N_ROT_PER_ITER; ++i) {
+            sum += gen.pop()[3];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_ROT_PER_ITER));
+}
+
+/**
+ * @brief Rotation3 batches; range(0) is 0 for quaternions, 1 for matrices
+ */
+static void Rotation_batch(benchmark::State& state) {
+    const auto matrices = state.range(0) != 0;
+    state.SetLabel(matrices ? "matrix" : "quaternion");
+    auto gen = lds2::Rotation3(BASE);
+    std::vector<double> res(N_ROT_PER_ITER * (matrices ? 9 : 4));
+    for (auto _ : state) {
+        if (matrices) {
+            gen.pop_batch_matrix(res);
+        } else {
+            gen.pop_batch(res);
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_ROT_PER_ITER));
+}
+
+/**
+ * @brief The quaternion-to-matrix step alone
+ */
+static void Rotation_quat_to_matrix(benchmark::State& state) {
+    auto gen = lds2::Rotation3(BASE);
+    std::vector<double> quat(N_ROT_PER_ITER * 4);
+    gen.pop_batch(quat);
+    std::vector<double> mat(N_ROT_PER_ITER * 9);
+    for (auto _ : state) {
+        lds2::quat_to_matrix(quat, mat);
+        benchmark::DoNotOptimize(mat.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_ROT_PER_ITER));
+}
+
+BENCHMARK(Rotation_sphere3_pop);
+BENCHMARK(Rotation_pop);
+BENCHMARK(Rotation_batch)->Arg(0)->Arg(1);
+BENCHMARK(Rotation_quat_to_matrix);
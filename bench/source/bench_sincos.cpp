@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <cstddef>                       // for size_t
+#include <sphere_n/radical_inverse.hpp>  // for radical_inverse
+#include <sphere_n/sincos.hpp>           // for sin_cos, Accuracy
+#include <sphere_n/sphere_n.hpp>         // for map_sphere_n, PRIME_TABLE
+#include <vector>                        // for vector
+
+/** @brief Angles or points per benchmark iteration */
+static constexpr size_t N_PER_ITER = 1024;
+
+/**
+ * @brief Batch sin/cos in [0, π]; range(0) is the Accuracy
+ */
+static void SinCos_batch(benchmark::State& state) {
+    const auto acc = static_cast<lds2::Accuracy>(state.range(0));
+    std::vector<double> x(N_PER_ITER);
+    for (auto i = 0U; i != N_PER_ITER; ++i) {
+        x[i] = 3.14159 * lds2::radical_inverse(i + 1, 2);
+    }
+    std::vector<double> s(N_PER_ITER);
+    std::vector<double> c(N_PER_ITER);
+    for (auto _ : state) {
+        lds2::sin_cos(acc, x, s, c);
+        benchmark::DoNotOptimize(s.data());
+        benchmark::DoNotOptimize(c.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_PER_ITER));
+}
+
+/**
+ * @brief map_sphere_n on S^m; range(0) is m, range(1) the Accuracy
+ */
+static void MapSphereN_accuracy(benchmark::State& state) {
+    const auto m = static_cast<size_t>(state.range(0));
+    const auto acc = static_cast<lds2::Accuracy>(state.range(1));
+    std::vector<double> u(N_PER_ITER * m);
+    for (auto k = 0U; k != N_PER_ITER; ++k) {
+        for (auto i = 0U; i != m; ++i) {
+            u[k * m + i] = lds2::radical_inverse(k + 1, lds2::PRIME_TABLE[i]);
+        }
+    }
+    std::vector<double> res(N_PER_ITER * (m + 1));
+    for (auto _ : state) {
+        lds2::map_sphere_n(m, u, res, lds2::Inversion::interp, acc);
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(static_cast<long>(state.iterations() * N_PER_ITER));
+}
+
+BENCHMARK(SinCos_batch)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(MapSphereN_accuracy)->ArgsProduct({{4, 16}, {0, 1, 2}});
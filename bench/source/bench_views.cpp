@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>  // for State, DoNotOptimize, BENCHMARK
+
+#include <span>                   // for span
+#include <sphere_n/sphere_n.hpp>  // for SphereN, PRIME_TABLE
+#include <sphere_n/views.hpp>     // for sphere_n_view
+#include <vector>                 // for vector
+
+/** @brief Points consumed per benchmark iteration */
+static constexpr long N_POINTS_PER_ITER = 1024;
+
+/**
+ * @brief Consume points through `pop()`, one vector per point
+ */
+static void SphereN_pop_vector(benchmark::State& state) {
+    const std::vector<unsigned long> base(std::begin(lds2::PRIME_TABLE),
+                                          std::begin(lds2::PRIME_TABLE) + state.range(0));
+    auto sgen = lds2::SphereN(base);
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (auto i = 0; i != N_POINTS_PER_ITER; ++i) {
+            sum += sgen.pop()[0];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * N_POINTS_PER_ITER);
+}
+
+/**
+ * @brief Consume points through `sphere_n_view()`, reusing one buffer
+ *
+ * The view is built once, as the generator of `SphereN_pop_vector`, and
+ * every iteration continues the sequence through the same iterator.
+ */
+static void SphereN_view(benchmark::State& state) {
+    const std::vector<unsigned long> base(std::begin(lds2::PRIME_TABLE),
+                                          std::begin(lds2::PRIME_TABLE) + state.range(0));
+    auto view = lds2::sphere_n_view(base);
+    auto it = view.begin();
+    for (auto _ : state) {
+        auto sum = 0.0;
+        for (auto i = 0; i != N_POINTS_PER_ITER; ++i, ++it) {
+            sum += (*it)[0];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * N_POINTS_PER_ITER);
+}
+
+BENCHMARK(SphereN_pop_vector)->Arg(4)->Arg(16);
+BENCHMARK(SphereN_view)->Arg(4)->Arg(16);
@@ -0,0 +1,3 @@
+#include <benchmark/benchmark.h>  // for BENCHMARK_MAIN
+
+BENCHMARK_MAIN();
@@ -4,17 +4,21 @@
  *  @brief Cylindrical coordinate method for generating points on N-dimensional spheres.
  */
 
-#include <array>    // for array
-#include <cassert>  // for assert
-#include <cstddef>  // for size_t
-#include <memory>   // for unique_ptr, make_unique
-#include <span>     // for span
+#include <array>            // for array
+#include <cassert>          // for assert
+#include <cstddef>          // for size_t
+#include <memory>           // for unique_ptr
+#include <memory_resource>  // for memory_resource, polymorphic_allocator
+#include <span>             // for span
 // #include <type_traits>  // for move, remove_reference<>::type
 #include <variant>  // for visit, variant
 #include <vector>   // for vector
 // #include <xtensor/xarray.hpp>  // for xtensor, xarray
 
-#include <ldsgen/lds.hpp>  // for VdCorput, Sphere
+#include <ldsgen/lds.hpp>          // for VdCorput, Sphere
+#include <sphere_n/gen_state.hpp>  // for GenState, checked_bases
+#include <sphere_n/pmr.hpp>        // for PmrPtr, make_pmr
+#include <sphere_n/sincos.hpp>     // for Accuracy
 
 namespace lds2 {
     // using Arr = xt::xarray<double, xt::layout_type::row_major>;
@@ -37,9 +41,10 @@ namespace lds2 {
      * @brief Variant type for recursive cylindrical generator dispatching.
      *
      * Holds either a Circle (2D base case) or a CylindN (recursive N-dimensional case)
-     * for the cylindrical coordinate generation algorithm.
+     * for the cylindrical coordinate generation algorithm. The nodes are
+     * allocated from the memory resource of the enclosing CylindN.
      */
-    using CylindVariant = std::variant<std::unique_ptr<Circle>, std::unique_ptr<CylindN>>;
+    using CylindVariant = std::variant<PmrPtr<Circle>, PmrPtr<CylindN>>;
 
      /**
       * Generate using cylindrical coordinate method
@@ -77,10 +82,19 @@ namespace lds2 {
       */
     class CylindN {
       private:
+        size_t n;
+        unsigned long b;
+        unsigned long b_circle = 0;  ///< base of the Circle leaf (n == 2 only)
+        unsigned long count = 0;
         VdCorput vdc;
         CylindVariant c_gen;
 
+        auto collect_bases(vector<unsigned long>& res) const -> void;
+
       public:
+        /** @brief Allocator used for the nested generators and `pop(mr)` results. */
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
         /**
          * @brief Construct a new CylindN object
          *
@@ -90,7 +104,12 @@ namespace lds2 {
          * keyword indicates that this constructor can only be used for explicit
          * construction and not for implicit conversions.
          *
+         * All nested generators are allocated from `alloc`, so a
+         * `std::pmr::monotonic_buffer_resource` holds the whole generator tree
+         * in one block.
+         *
          * @param[in] base Span containing base numbers for sequence generation
+         * @param[in] alloc Allocator for the nested generators
          *
          * @verbatim
          *   Base: [b0, b1, b2, ..., bn]
@@ -102,16 +121,44 @@ namespace lds2 {
          *       cylindrical point
          * @endverbatim
          */
-        explicit CylindN(span<const unsigned long> base) : vdc{base[0]} {
-            const auto n = base.size();
+        explicit CylindN(span<const unsigned long> base, const allocator_type& alloc = {})
+            : n{base.size()}, b{base[0]}, vdc{base[0]} {
             assert(n >= 2);
+            auto* mr = alloc.resource();
             if (n == 2) {
-                this->c_gen = std::make_unique<Circle>(base[1]);
+                this->b_circle = base[1];
+                this->c_gen = make_pmr<Circle>(mr, base[1]);
             } else {
-                this->c_gen = std::make_unique<CylindN>(base.last(n - 1));
+                this->c_gen = make_pmr<CylindN>(mr, base.last(n - 1));  // alloc is propagated
             }
         }
 
+        /**
+         * @brief Restore a CylindN object from a saved state
+         *
+         * Rebuilds the generator from the saved bases and seeks every level to
+         * the saved index, without replaying `pop()`.
+         *
+         * @param[in] state State returned by `state()`
+         * @param[in] alloc Allocator for the nested generators
+         * @throw std::invalid_argument unless the state has at least 2 bases, all >= 2
+         */
+        explicit CylindN(const GenState& state, const allocator_type& alloc = {})
+            : CylindN(checked_bases(state, "CylindN", 2), alloc) {
+            this->reseed(state.index);
+        }
+
+        /**
+         * @brief Allocator-extended copy constructor
+         *
+         * Deep-copies the nested generators into `alloc`, including their
+         * current position. The cost is O(n).
+         *
+         * @param[in] other The generator to copy
+         * @param[in] alloc Allocator for the nested generators
+         */
+        CylindN(const CylindN& other, const allocator_type& alloc);
+
         /**
          * @brief Generate the next point using cylindrical coordinate method
          *
@@ -138,6 +185,54 @@ namespace lds2 {
          */
         auto pop() -> vector<double>;
 
+        /**
+         * @brief Generate the next point into a memory-resource backed vector
+         *
+         * @param[in] mr The memory resource for the result
+         * @return std::pmr::vector<double> An (n+1)-dimensional point
+         */
+        auto pop(std::pmr::memory_resource* mr) -> std::pmr::vector<double>;
+
+        /**
+         * @brief Generate the next point into a caller-provided buffer
+         *
+         * The nested generators write their coordinates directly into the
+         * leading part of `res`, so no temporary vectors are created.
+         *
+         * @param[in,out] res Output buffer of size `size()`
+         */
+        auto pop_into(span<double> res) -> void;
+
+        /**
+         * @brief Number of coordinates of each generated point
+         * @return size_t
+         */
+        auto size() const -> size_t { return this->n + 1; }
+
+        /**
+         * @brief Get the allocator used for the nested generators
+         * @return allocator_type
+         */
+        auto get_allocator() const -> allocator_type {
+            return std::visit([](const auto& t) { return allocator_type(t.get_deleter().mr); },
+                              this->c_gen);
+        }
+
+        /**
+         * @brief Copy the generator, including its current position
+         *
+         * The copy allocates from the same memory resource. The cost is O(n).
+         *
+         * @return CylindN
+         */
+        auto clone() const -> CylindN { return CylindN(*this, this->get_allocator()); }
+
+        /**
+         * @brief Snapshot of the bases and the current position
+         * @return GenState
+         */
+        auto state() const -> GenState;
+
         /**
          * @brief reseed
          *
@@ -151,4 +246,36 @@ namespace lds2 {
         auto reseed(unsigned long seed) -> void;
     };
 
+    /**
+     * @brief Map points of the unit hypercube onto S^m with the cylindrical method
+     *
+     * Applies the same transformation as `CylindN` to explicit sequence
+     * values: `u[0]` drives the outermost level and `u[m - 1]` the innermost
+     * circle. Feeding the values `radical_inverse(k, base[i])` reproduces the
+     * k-th point of `CylindN(base)`.
+     *
+     * @param[in] m Number of sequence values per point (m >= 2)
+     * @param[in] u Row-major input, `count * m` values in [0, 1)
+     * @param[out] res Row-major output, `count * (m + 1)` coordinates
+     * @param[in] acc Accuracy policy of the circle's sin/cos evaluations
+     */
+    auto map_cylind_n(size_t m, span<const double> u, span<double> res,
+                      Accuracy acc = Accuracy::exact) -> void;
+
+    /**
+     * @brief Map points on S^m back to the values of the unit hypercube
+     *
+     * Inverse of `map_cylind_n()`: for every unit vector, recovers the
+     * sequence values that `CylindN` would have consumed to produce it.
+     * Level len set x[len] = cos(phi) after scaling x[0..len) by sin(phi),
+     * so cos(phi) = x[len] / |x[0..len]| and no trigonometry is needed
+     * besides the angle of the innermost circle. Inputs need not be unit
+     * vectors; only their direction matters.
+     *
+     * @param[in] m Number of sequence values per point (m >= 2)
+     * @param[in] x Row-major input, `count * (m + 1)` coordinates
+     * @param[out] u Row-major output, `count * m` values in [0, 1]
+     */
+    auto inverse_cylind_n(size_t m, span<const double> x, span<double> u) -> void;
+
 }  // namespace lds2
@@ -0,0 +1,168 @@
+#pragma once
+
+/** @file factory.hpp
+ *  @brief Generators chosen by kind and dimension, with kernels selected once at runtime.
+ */
+
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <span>     // for span
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include <sphere_n/sincos.hpp>    // for Accuracy
+#include <sphere_n/sphere_n.hpp>  // for Inversion, Isa
+
+namespace lds2 {
+    using std::span;
+    using std::vector;
+
+    /**
+     * @brief Sequence produced by `make_generator()`
+     */
+    enum class GeneratorKind {
+        sphere,  ///< points of `Sphere` (S^2), `Sphere3` (S^3) or `SphereN`
+        cylind,  ///< points of `CylindN`
+        halton,  ///< points of `HaltonN` in the unit hypercube
+    };
+
+    /**
+     * @brief Options of `make_generator()`
+     */
+    struct GeneratorOptions {
+        Inversion inversion = Inversion::interp;  ///< Tp inversion of `GeneratorKind::sphere`
+        Accuracy accuracy = Accuracy::exact;      ///< accuracy of the sin/cos evaluations
+        unsigned long seed = 0;                   ///< points skipped at the start
+        bool simd = true;                         ///< allow kernels wider than the build baseline
+    };
+
+    /**
+     * @brief Type-erased generator returned by `make_generator()`
+     *
+     * Wraps one kernel behind a single virtual call per batch: `pop_batch()`
+     * generates the radical inverses of the whole batch and maps them with
+     * a kernel pointer resolved at construction, so neither the dimension
+     * nor the instruction set is looked at per point. `pop_into()` is a
+     * batch of one and pays the dispatch for every point; prefer batches.
+     */
+    class Generator {
+      public:
+        /**
+         * @brief Interface of the wrapped kernels
+         */
+        struct Kernel {
+            virtual ~Kernel() = default;
+            virtual auto pop_batch(span<double> res) -> void = 0;
+            virtual auto reseed(unsigned long seed) -> void = 0;
+            virtual auto skip(unsigned long n) -> void = 0;
+            virtual auto clone() const -> std::unique_ptr<Kernel> = 0;
+        };
+
+      private:
+        std::unique_ptr<Kernel> kernel;
+        size_t n_dim;
+        std::string kernel_name;
+
+      public:
+        /**
+         * @brief Wrap a kernel
+         *
+         * @param[in] kernel The kernel
+         * @param[in] dim Coordinates of each point
+         * @param[in] name Description of the kernel
+         */
+        Generator(std::unique_ptr<Kernel> kernel, size_t dim, std::string name)
+            : kernel{std::move(kernel)}, n_dim{dim}, kernel_name{std::move(name)} {}
+
+        Generator(Generator&&) noexcept = default;
+        auto operator=(Generator&&) noexcept -> Generator& = default;
+
+        Generator(const Generator& other)
+            : kernel{other.kernel->clone()}, n_dim{other.n_dim}, kernel_name{other.kernel_name} {}
+
+        auto operator=(const Generator& other) -> Generator& {
+            if (this != &other) *this = Generator(other);
+            return *this;
+        }
+
+        /**
+         * @brief Next `res.size() / size()` points
+         *
+         * @param[out] res Row-major output, a multiple of `size()` values
+         */
+        auto pop_batch(span<double> res) -> void { this->kernel->pop_batch(res); }
+
+        /**
+         * @brief Next point into a caller-provided buffer
+         *
+         * @param[out] res Output buffer of `size()` values
+         */
+        auto pop_into(span<double> res) -> void { this->kernel->pop_batch(res); }
+
+        /**
+         * @brief Next point
+         * @return vector<double>
+         */
+        auto pop() -> vector<double> {
+            vector<double> res(this->n_dim);
+            this->kernel->pop_batch(res);
+            return res;
+        }
+
+        /**
+         * @brief Restart the sequence after `seed` points
+         *
+         * @param[in] seed The seed value to reset to
+         */
+        auto reseed(unsigned long seed) -> void { this->kernel->reseed(seed); }
+
+        /**
+         * @brief Skip the next n points in O(1)
+         *
+         * @param[in] n Number of points to skip
+         */
+        auto skip(unsigned long n) -> void { this->kernel->skip(n); }
+
+        /**
+         * @brief Number of coordinates of each point
+         * @return size_t
+         */
+        auto size() const -> size_t { return this->n_dim; }
+
+        /**
+         * @brief The selected kernel, e.g. "sphere/fixed<5>/avx2"
+         * @return const std::string&
+         */
+        auto name() const -> const std::string& { return this->kernel_name; }
+    };
+
+    /**
+     * @brief Generator of the given kind with `dim` coordinates per point
+     *
+     * The bases are the first primes of `PRIME_TABLE`: dim - 1 of them for
+     * the spheres (points on S^(dim - 1)), dim for `GeneratorKind::halton`.
+     * The kernel is chosen once, here:
+     *
+     * @verbatim
+     *   sphere, dim == 3              map_cylind_n (the map of Sphere)
+     *   sphere, 4 <= dim <= 9         map_sphere_n instantiated for dim - 1 values, unrolled
+     *   sphere, dim > 9               map_sphere_n with a runtime dimension
+     *   cylind                        map_cylind_n
+     *   halton                        HaltonN::pop_batch
+     *   each sphere kernel            in the widest Isa of detect_isa() (unless !simd)
+     * @endverbatim
+     *
+     * The points equal those of the classes named in `GeneratorKind` built
+     * on the same bases, up to the rounding of the batched mapping.
+     *
+     * @param[in] kind Sequence to generate
+     * @param[in] dim Coordinates per point: >= 3 for the spheres, >= 1 for halton,
+     *                and at most the number of primes in `PRIME_TABLE` (+ 1 for the spheres)
+     * @param[in] opts Options
+     * @return Generator
+     * @throw std::invalid_argument if `dim` is out of range
+     */
+    auto make_generator(GeneratorKind kind, size_t dim, const GeneratorOptions& opts = {})
+        -> Generator;
+}  // namespace lds2
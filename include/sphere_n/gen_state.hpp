@@ -0,0 +1,85 @@
+#pragma once
+
+/** @file gen_state.hpp
+ *  @brief Compact, serializable position of a sphere sequence generator.
+ */
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t, SIZE_MAX
+#include <iosfwd>   // for istream, ostream
+#include <span>     // for span
+#include <vector>   // for vector
+
+namespace lds2 {
+    enum class Accuracy;   // defined in sincos.hpp
+    enum class Antipodal;  // defined in rotation.hpp
+    enum class Inversion;  // defined in sphere_n.hpp
+
+    /**
+     * @brief Snapshot of a generator position
+     *
+     * A `GenState` holds everything that is needed to rebuild a `Sphere3`,
+     * `SphereN` or `CylindN` at a given position without replaying `pop()`:
+     * the bases of all levels, the sequence index and the modes selected with
+     * `set_inversion()` and `set_accuracy()` (plus the antipodal method of a
+     * `Rotation3`). Every level of a generator advances in lockstep (one
+     * `pop()` of the parent pops each nested generator once, and `reseed()`
+     * is propagated to all levels), so a single index describes the
+     * position of every level.
+     *
+     * @verbatim
+     *   SphereN [b0, b1, ..., bm], k pops after reseed(s)
+     *       |
+     *       v  state()
+     *   GenState { base = [b0, ..., bm], index = s + k }
+     *       |
+     *       v  SphereN(state)  ==  SphereN(base); reseed(index)
+     * @endverbatim
+     */
+    struct GenState {
+        std::vector<unsigned long> base;  ///< Bases of all levels, outermost first
+        unsigned long index = 0;          ///< Seed that reproduces the current position
+        Inversion inversion{};            ///< Tp inversion method, `Inversion::interp` by default
+        Accuracy accuracy{};              ///< sin/cos accuracy policy, `Accuracy::exact` by default
+        Antipodal antipodal{};            ///< `Rotation3` q ~ -q method, `hemisphere` by default
+    };
+
+    /**
+     * @brief Bases of a state about to be restored, after checking them
+     *
+     * Restoring constructors call this before building anything, so a
+     * corrupted or foreign state is rejected instead of reaching the
+     * assertions (or the endless loops of a base below 2) of the generators.
+     *
+     * @param[in] state The state
+     * @param[in] who Name of the generator, for the message
+     * @param[in] min_bases Fewest bases the generator accepts
+     * @param[in] max_bases Most bases the generator accepts
+     * @return std::span<const unsigned long> `state.base`
+     * @throw std::invalid_argument if the number of bases is out of range or a base is below 2
+     */
+    auto checked_bases(const GenState& state, const char* who, std::size_t min_bases,
+                       std::size_t max_bases = SIZE_MAX) -> std::span<const unsigned long>;
+
+    /**
+     * @brief Write a generator state in a portable binary format
+     *
+     * The record is a magic tag followed by little-endian 64-bit integers:
+     * the format version, the modes, the number of bases, the bases and the
+     * index. The modes word holds the inversion method in its low byte, the
+     * accuracy policy in the next one and the antipodal method in the third.
+     *
+     * @param[in,out] os Output stream (opened in binary mode)
+     * @param[in] state The state to write
+     */
+    auto write_state(std::ostream& os, const GenState& state) -> void;
+
+    /**
+     * @brief Read a generator state written by `write_state()`
+     *
+     * @param[in,out] is Input stream (opened in binary mode)
+     * @return GenState The restored state
+     * @throw std::runtime_error if the record is truncated or malformed
+     */
+    auto read_state(std::istream& is) -> GenState;
+}  // namespace lds2
@@ -0,0 +1,142 @@
+#pragma once
+
+/** @file halton_n.hpp
+ *  @brief N-dimensional Halton sequence generator for hypercube sampling.
+ */
+
+#include <cstddef>  // for size_t
+#include <span>     // for span
+#include <vector>   // for vector
+
+#include <sphere_n/gen_state.hpp>  // for GenState, checked_bases
+
+namespace lds2 {
+    using std::span;
+    using std::vector;
+
+    /**
+     * @brief N-dimensional Halton sequence generator
+     *
+     * Coordinate d of the k-th point is the radical inverse of k in base
+     * `base[d]`, i.e. the value of `VdCorput(base[d])`. Every point is
+     * computed from its index alone, so the generator holds no per-dimension
+     * state besides the bases and can jump to any index in O(1).
+     *
+     * The digit loops run over blocks of independent lanes with floating
+     * point division in place of integer division, so they vectorize:
+     * across dimensions for a single point (`pop_into()`, `point()`) and
+     * across consecutive points of one dimension for batches (`pop_batch()`,
+     * `pop_soa()`). All paths give bit-identical values.
+     *
+     * @verbatim
+     *   pop_batch (row-major):   [x_0(k), ..., x_{n-1}(k), x_0(k+1), ...]
+     *   pop_soa (coord-major):   [x_0(k), x_0(k+1), ..., x_1(k), x_1(k+1), ...]
+     * @endverbatim
+     */
+    class HaltonN {
+        vector<unsigned long> base;
+        vector<double> fbase;
+        unsigned long count = 0;
+
+        template <typename Store> auto pop_blocks(size_t n_pts, Store&& store) -> void;
+
+      public:
+        /**
+         * @brief Construct a new HaltonN object
+         *
+         * @param[in] base Bases of the coordinates (each >= 2)
+         * @throw std::invalid_argument if `base` is empty
+         */
+        explicit HaltonN(span<const unsigned long> base);
+
+        /**
+         * @brief Construct a HaltonN object on the first `dim` primes of PRIME_TABLE
+         *
+         * @param[in] dim Number of coordinates
+         * @throw std::invalid_argument if `dim` is 0 or exceeds the number of primes in PRIME_TABLE
+         */
+        explicit HaltonN(size_t dim);
+
+        /**
+         * @brief Construct a generator from a snapshot taken with `state()`
+         *
+         * @param[in] state Bases and position of the sequence
+         * @throw std::invalid_argument unless the state has at least 1 base, all >= 2
+         */
+        explicit HaltonN(const GenState& state) : HaltonN(checked_bases(state, "HaltonN", 1)) {
+            this->count = state.index;
+        }
+
+        /**
+         * @brief Generate the next point
+         * @return vector<double> A point of the unit hypercube
+         */
+        auto pop() -> vector<double> {
+            vector<double> res(this->size());
+            this->pop_into(res);
+            return res;
+        }
+
+        /**
+         * @brief Generate the next point into a buffer
+         * @param[out] res Output buffer of size `size()`
+         */
+        auto pop_into(span<double> res) -> void;
+
+        /**
+         * @brief Generate the next `res.size() / size()` points, row-major
+         * @param[out] res Output buffer, a multiple of `size()` values
+         */
+        auto pop_batch(span<double> res) -> void;
+
+        /**
+         * @brief Generate the next `res.size() / size()` points, coordinate-major
+         *
+         * Coordinate d of the i-th point is written to `res[d * count + i]`.
+         *
+         * @param[out] res Output buffer, a multiple of `size()` values
+         */
+        auto pop_soa(span<double> res) -> void;
+
+        /**
+         * @brief The point with index k, independent of the current position
+         *
+         * `point(k, res)` gives the same values as `pop_into(res)` after
+         * `reseed(k - 1)`. k must be below 2^51.
+         *
+         * @param[in] k Index into the sequence
+         * @param[out] res Output buffer of size `size()`
+         */
+        auto point(unsigned long k, span<double> res) const -> void;
+
+        /**
+         * @brief Skip the next n points
+         * @param[in] n Number of points to skip
+         */
+        auto skip(unsigned long n) -> void { this->count += n; }
+
+        /**
+         * @brief Reset the sequence generator to a specific seed
+         * @param[in] seed The seed value to reset to
+         */
+        auto reseed(unsigned long seed) -> void { this->count = seed; }
+
+        /**
+         * @brief Number of coordinates of each generated point
+         * @return size_t
+         */
+        auto size() const -> size_t { return this->base.size(); }
+
+        /**
+         * @brief Snapshot of the bases and the current position
+         * @return GenState
+         */
+        auto state() const -> GenState { return GenState{this->base, this->count}; }
+
+        /**
+         * @brief Independent copy continuing from the current position
+         * @return HaltonN
+         */
+        auto clone() const -> HaltonN { return *this; }
+    };
+}  // namespace lds2
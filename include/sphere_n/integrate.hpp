@@ -0,0 +1,167 @@
+#pragma once
+
+/** @file integrate.hpp
+ *  @brief Fused, multi-threaded quasi-Monte Carlo integration over S^m.
+ */
+
+#include <cmath>       // for abs
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+#include <span>        // for span
+
+#include <sphere_n/sphere_n.hpp>  // for Inversion, Mapping
+
+namespace lds2 {
+    using std::span;
+
+    /**
+     * @brief Compensated (Kahan-Babuska-Neumaier) running sum
+     *
+     * The rounding error of every addition is carried in a separate term,
+     * so the error of a sum of N values stays O(ε) instead of O(N ε).
+     */
+    struct CompensatedSum {
+        double sum = 0.0;   ///< running sum
+        double comp = 0.0;  ///< accumulated rounding errors
+
+        /**
+         * @brief Add a value
+         *
+         * @param[in] x The value
+         */
+        auto add(double x) -> void {
+            const auto t = this->sum + x;
+            this->comp += (std::abs(this->sum) >= std::abs(x)) ? (this->sum - t) + x
+                                                                : (x - t) + this->sum;
+            this->sum = t;
+        }
+
+        /**
+         * @brief Add another compensated sum
+         *
+         * @param[in] other The sum to add
+         */
+        auto merge(const CompensatedSum& other) -> void {
+            this->add(other.sum);
+            this->comp += other.comp;
+        }
+
+        /**
+         * @brief The compensated value
+         * @return double
+         */
+        auto value() const -> double { return this->sum + this->comp; }
+    };
+
+    /**
+     * @brief Sums of f and f^2 over one block of points
+     */
+    struct BlockSums {
+        CompensatedSum f;   ///< sum of f(x)
+        CompensatedSum f2;  ///< sum of f(x)^2
+    };
+
+    /**
+     * @brief Options of `integrate()`
+     */
+    struct IntegrateOptions {
+        size_t threads = 0;                       ///< worker threads, 0 for all cores
+        size_t block_points = 256;                ///< points generated and evaluated per block
+        size_t report_every = 0;                  ///< points between running estimates, 0: none
+        double abs_tol = 0.0;                     ///< stop once the estimate changes by <= this
+        double rel_tol = 0.0;                     ///< ... or by <= this times the estimate
+        Mapping mapping = Mapping::sphere;        ///< mapping of the sequence values
+        Inversion inversion = Inversion::interp;  ///< Tp inversion of `Mapping::sphere`
+    };
+
+    /**
+     * @brief Running or final estimate of the mean of f over the sphere
+     */
+    struct Estimate {
+        size_t n_points = 0;     ///< points evaluated so far
+        double mean = 0.0;       ///< average of f, the integral divided by the area of S^m
+        double std_error = 0.0;  ///< sqrt(var f / n_points), the error of plain Monte Carlo
+        double change = 0.0;     ///< |mean - previous mean|, infinite for the first estimate
+        bool converged = false;  ///< the change met `abs_tol` or `rel_tol`
+    };
+
+    /**
+     * @brief Callback receiving the running estimates; return false to stop early
+     */
+    using ProgressFn = std::function<bool(const Estimate&)>;
+
+    /**
+     * @brief Callback evaluating one block of row-major points into block sums
+     */
+    using BlockFn = std::function<void(span<const double>, BlockSums&)>;
+
+    /**
+     * @brief Block-level driver behind `integrate()`
+     *
+     * @param[in] base Bases of the m sequence values; the points lie on S^m
+     * @param[in] n Largest number of points
+     * @param[in] opts Options
+     * @param[in] block_fn Evaluates a block of points, called concurrently
+     * @param[in] progress Receives every running estimate, may be empty
+     * @return Estimate The last estimate
+     * @throw Rethrows the first exception of `block_fn`, after all workers have stopped
+     */
+    auto integrate_blocks(span<const unsigned long> base, size_t n, const IntegrateOptions& opts,
+                          const BlockFn& block_fn, const ProgressFn& progress) -> Estimate;
+
+    /**
+     * @brief Average of f over the first n points of the sphere sequence, without storing them
+     *
+     * The index range is cut into blocks of `block_points` points. Worker
+     * threads claim blocks through an atomic counter; each block is
+     * generated from its first index alone (radical inverses, as in
+     * `HaltonN`, mapped by `map_sphere_n()` or `map_cylind_n()`) into a
+     * small per-thread buffer that stays in cache, and is handed straight
+     * to f. Every block accumulates its own compensated sums, and the block
+     * sums are reduced in block order, so the result is bit-identical for
+     * any number of threads. If f throws, no further blocks are claimed and
+     * the first exception is rethrown on the calling thread once every
+     * worker has stopped.
+     *
+     * With `report_every > 0` the blocks are processed in rounds of about
+     * that many points; after each round the running estimate is passed to
+     * `progress`, and the integration stops when `progress` returns false
+     * or when the change since the previous round meets `abs_tol` or
+     * `rel_tol`. For low-discrepancy points the change between rounds is a
+     * better error indicator than `std_error`, which assumes independent
+     * samples and overestimates the error of smooth integrands.
+     *
+     * @verbatim
+     *   blocks:   [0, B) [B, 2B) [2B, 3B) ...      claimed by threads in any order
+     *                |      |       |
+     *                v      v       v
+     *   sums:       s_0    s_1     s_2   ...      one compensated pair per block
+     *                \______|_______/
+     *                       v
+     *   total:   ((s_0 + s_1) + s_2) + ...        always in block order
+     * @endverbatim
+     *
+     * @tparam F Callable as `double(span<const double>)`; called concurrently
+     *           from several threads, so it must be thread-safe
+     * @param[in] f The integrand, evaluated at points of `base.size() + 1` coordinates
+     * @param[in] base Bases of the m sequence values, as for `SphereN` or `CylindN`
+     * @param[in] n Largest number of points
+     * @param[in] opts Options
+     * @param[in] progress Receives every running estimate, may be empty
+     * @return Estimate The last estimate
+     */
+    template <typename F>
+    auto integrate(F&& f, span<const unsigned long> base, size_t n,
+                   const IntegrateOptions& opts = {}, const ProgressFn& progress = {})
+        -> Estimate {
+        const auto dim = base.size() + 1;
+        const auto block_fn = [&f, dim](span<const double> pts, BlockSums& sums) {
+            for (auto r = size_t{0}; r * dim != pts.size(); ++r) {
+                const double v = f(pts.subspan(r * dim, dim));
+                sums.f.add(v);
+                sums.f2.add(v * v);
+            }
+        };
+        return integrate_blocks(base, n, opts, block_fn, progress);
+    }
+}  // namespace lds2
@@ -0,0 +1,159 @@
+#pragma once
+
+/** @file numa.hpp
+ *  @brief NUMA-aware bulk generation of sphere points with first-touch output placement.
+ */
+
+#include <cstddef>      // for size_t
+#include <memory>       // for unique_ptr
+#include <span>         // for span
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+#include <sphere_n/sincos.hpp>    // for Accuracy
+#include <sphere_n/sphere_n.hpp>  // for Inversion
+
+namespace lds2 {
+    using std::span;
+    using std::vector;
+
+    /**
+     * @brief A NUMA node and the CPUs of it that this process may run on
+     */
+    struct NumaNode {
+        unsigned id;       ///< node number of the operating system
+        vector<int> cpus;  ///< usable CPUs of the node, ascending
+    };
+
+    /**
+     * @brief Parse a CPU list such as "0-3,8-11,16"
+     *
+     * @param[in] list CPU list in the format of the Linux sysfs and cpusets
+     * @return vector<int> The CPUs, in list order; empty if the list is malformed
+     */
+    auto parse_cpu_list(std::string_view list) -> vector<int>;
+
+    /**
+     * @brief NUMA nodes with at least one CPU this process may run on
+     *
+     * On Linux the nodes are read from /sys/devices/system/node and
+     * intersected with the affinity mask of the calling thread. Elsewhere,
+     * or when the node information is unavailable, all usable CPUs form a
+     * single node 0. The result is never empty.
+     *
+     * @return vector<NumaNode> Nodes ordered by id
+     */
+    auto numa_topology() -> vector<NumaNode>;
+
+    /**
+     * @brief Options of `generate_bulk()`
+     */
+    struct BulkOptions {
+        size_t threads = 0;                       ///< worker threads, 0 for all usable CPUs
+        bool numa_aware = true;                   ///< pin, first-touch and replicate per node
+        Inversion inversion = Inversion::interp;  ///< Tp inversion of the levels of S^m
+        Accuracy accuracy = Accuracy::exact;      ///< accuracy of the sin/cos evaluations
+    };
+
+    /**
+     * @brief Contiguous range of points written by the workers of one NUMA node
+     */
+    struct NodeSlice {
+        unsigned node;  ///< node that holds the memory of the range
+        size_t first;   ///< index of the first point
+        size_t count;   ///< number of points
+    };
+
+    /**
+     * @brief Points produced by `generate_bulk()`
+     *
+     * Owns the row-major coordinates and records which node's workers
+     * wrote which range, so that consumers can process each range on the
+     * node that holds it.
+     */
+    class BulkPoints {
+        std::unique_ptr<double[]> data;
+        size_t n_points = 0;
+        size_t n_dim = 0;
+        vector<NodeSlice> node_slices;
+
+        friend auto generate_bulk(span<const unsigned long> base, size_t n,
+                                  const BulkOptions& opts) -> BulkPoints;
+
+      public:
+        /**
+         * @brief Row-major coordinates, `dim()` values per point
+         * @return span<const double>
+         */
+        auto points() const -> span<const double> {
+            return span<const double>(this->data.get(), this->n_points * this->n_dim);
+        }
+
+        /**
+         * @brief Coordinates of point k
+         *
+         * @param[in] k Index of the point
+         * @return span<const double>
+         */
+        auto point(size_t k) const -> span<const double> {
+            return this->points().subspan(k * this->n_dim, this->n_dim);
+        }
+
+        /**
+         * @brief Number of points
+         * @return size_t
+         */
+        auto size() const -> size_t { return this->n_points; }
+
+        /**
+         * @brief Number of coordinates of each point
+         * @return size_t
+         */
+        auto dim() const -> size_t { return this->n_dim; }
+
+        /**
+         * @brief Ranges of points by the node that wrote them, in index order
+         * @return span<const NodeSlice>
+         */
+        auto slices() const -> span<const NodeSlice> { return this->node_slices; }
+    };
+
+    /**
+     * @brief First n points of the sphere sequence, generated by a pool of threads
+     *
+     * The points are those of `SphereN` (`Sphere3` for 3 bases, `Sphere` for
+     * 2): point k is computed from the radical inverses of k + 1 and mapped
+     * by `map_sphere_n()` (`map_cylind_n()` on S^2), so the result does not
+     * depend on the options other than `inversion` and `accuracy`.
+     *
+     * With `numa_aware` set, the workers are spread over the nodes of
+     * `numa_topology()` in proportion to their CPUs and pinned to one CPU
+     * each. Every worker owns one contiguous slice of the output, ordered
+     * by node, and is the first to write it; the output buffer is allocated
+     * without being touched, so under the first-touch policy of the
+     * operating system each page lands on the node of the thread that fills
+     * it. The first worker of each node builds a `TpTables` replica that all
+     * workers of the node read (`Inversion::interp` only; newton inversion
+     * reads the small shared tables).
+     *
+     * Without `numa_aware` the workers are not pinned, the output is
+     * zero-filled by the calling thread, so all of it lives on one node,
+     * the shared tables are read by everyone, and blocks are claimed
+     * dynamically: the naive scheme that `numa_aware` is measured against.
+     *
+     * @verbatim
+     *   node 0: cpu 0 [slice 0] cpu 1 [slice 1]  tables 0   <- pages of slices 0, 1 on node 0
+     *   node 1: cpu 8 [slice 2] cpu 9 [slice 3]  tables 1   <- pages of slices 2, 3 on node 1
+     * @endverbatim
+     *
+     * The first exception thrown by a worker, or by starting one, is
+     * rethrown once all workers have joined.
+     *
+     * @param[in] base Bases of the m sequence values; the points lie on S^m (m >= 2)
+     * @param[in] n Number of points
+     * @param[in] opts Options
+     * @return BulkPoints
+     */
+    auto generate_bulk(span<const unsigned long> base, size_t n, const BulkOptions& opts = {})
+        -> BulkPoints;
+}  // namespace lds2
@@ -0,0 +1,56 @@
+#pragma once
+
+/** @file pmr.hpp
+ *  @brief Owning pointers for generator nodes allocated from a std::pmr::memory_resource.
+ */
+
+#include <memory>           // for unique_ptr
+#include <memory_resource>  // for memory_resource, polymorphic_allocator
+#include <utility>          // for forward
+
+namespace lds2 {
+    /**
+     * @brief Deleter that returns an object to the memory resource it came from
+     *
+     * A `PmrDelete` remembers the `std::pmr::memory_resource` used to create
+     * the object, so that destroying the owning pointer destroys the object
+     * and deallocates its storage from the same resource. With a
+     * `std::pmr::monotonic_buffer_resource` the deallocation is a no-op and
+     * the whole generator tree is released at once with the resource.
+     *
+     * @tparam T Type of the owned object.
+     */
+    template <typename T> struct PmrDelete {
+        std::pmr::memory_resource* mr = std::pmr::get_default_resource();
+
+        void operator()(T* ptr) const { std::pmr::polymorphic_allocator<>(mr).delete_object(ptr); }
+    };
+
+    /** @brief Owning pointer to an object allocated from a memory resource. */
+    template <typename T> using PmrPtr = std::unique_ptr<T, PmrDelete<T>>;
+
+    /**
+     * @brief Create an object from a memory resource
+     *
+     * Allocator-aware types (those declaring `allocator_type`) receive the
+     * allocator through uses-allocator construction, so nested generators
+     * keep allocating from the same resource.
+     *
+     * @tparam T Type of the object to create.
+     * @param[in] mr The memory resource to allocate from.
+     * @param[in] args Constructor arguments.
+     * @return PmrPtr<T> Owning pointer to the new object.
+     *
+     * @verbatim
+     *   memory_resource
+     *     |
+     *     v
+     *   new_object<T>(args..., alloc) -> PmrPtr<T>{ptr, PmrDelete{mr}}
+     * @endverbatim
+     */
+    template <typename T, typename... Args>
+    auto make_pmr(std::pmr::memory_resource* mr, Args&&... args) -> PmrPtr<T> {
+        std::pmr::polymorphic_allocator<> alloc(mr);
+        return PmrPtr<T>(alloc.new_object<T>(std::forward<Args>(args)...), PmrDelete<T>{mr});
+    }
+}  // namespace lds2
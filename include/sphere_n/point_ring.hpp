@@ -0,0 +1,227 @@
+#pragma once
+
+/** @file point_ring.hpp
+ *  @brief Lock-free ring of point blocks, in process memory or POSIX shared memory.
+ */
+
+#include <cstddef>  // for size_t, byte
+#include <cstdint>  // for uint64_t
+#include <memory>   // for unique_ptr
+#include <span>     // for span
+#include <string>   // for string
+#include <utility>  // for move
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#    define SPHERE_N_HAS_SHM 1
+#else
+#    define SPHERE_N_HAS_SHM 0
+#endif
+
+namespace lds2 {
+    using std::span;
+
+    class PointRing;
+
+    /**
+     * @brief A claimed block of points, read in place from the ring
+     *
+     * The points stay valid until the block is destroyed or `release()` is
+     * called, which hands the slot back to the producer.
+     */
+    class PointBlock {
+        PointRing* ring = nullptr;
+        unsigned long block = 0;
+        unsigned long first = 0;
+        span<const double> pts;
+
+        friend class PointRing;
+        PointBlock(PointRing* ring, unsigned long block, unsigned long first,
+                   span<const double> pts)
+            : ring{ring}, block{block}, first{first}, pts{pts} {}
+
+      public:
+        PointBlock() = default;
+        PointBlock(PointBlock&& other) noexcept { *this = std::move(other); }
+        auto operator=(PointBlock&& other) noexcept -> PointBlock&;
+        PointBlock(const PointBlock&) = delete;
+        auto operator=(const PointBlock&) -> PointBlock& = delete;
+        ~PointBlock() { this->release(); }
+
+        /**
+         * @brief Row-major coordinates of the points in the block
+         * @return span<const double>
+         */
+        auto points() const -> span<const double> { return this->pts; }
+
+        /**
+         * @brief Sequence index of the first point (the `k` of `radical_inverse(k, b)`)
+         * @return unsigned long
+         */
+        auto first_index() const -> unsigned long { return this->first; }
+
+        /**
+         * @brief Position of the block in the stream of published blocks
+         * @return unsigned long
+         */
+        auto index() const -> unsigned long { return this->block; }
+
+        /**
+         * @brief Hand the slot back to the producer (idempotent)
+         */
+        auto release() -> void;
+    };
+
+    /**
+     * @brief Single-producer, multi-consumer ring of fixed-size point blocks
+     *
+     * The ring is one contiguous region: a header with the geometry and two
+     * cursors, followed by `slots` slots of `block_points * dim` doubles. The
+     * region lives either in process memory (`create_local()`, for threads
+     * and tests) or in a POSIX shared-memory object (`create_shared()` and
+     * `open_shared()`), so several processes can consume one generator
+     * without each building its own tables.
+     *
+     * Block i is stored in slot i mod slots. Every slot carries a sequence
+     * word, updated with atomic operations only:
+     *
+     * @verbatim
+     *   seq == i              slot free, producer may write block i
+     *   seq == i + 1          block i published, its claimant may read
+     *   seq == i + slots      block i released, slot free for block i + slots
+     *
+     *   producer:  wait seq == i -> fill -> seq = i + 1
+     *   consumer:  i = claimed.fetch_add(1) -> wait seq == i + 1 -> read
+     *              -> seq = i + slots
+     * @endverbatim
+     *
+     * Consumers get disjoint blocks through the shared claim cursor and read
+     * them in place. Waits spin with `std::this_thread::yield()`, so they work
+     * across processes without futexes or locks.
+     */
+    class PointRing {
+        struct Mapping;
+        std::unique_ptr<Mapping> map;
+        std::byte* base = nullptr;
+        std::uint64_t next_block = 0;  ///< producer cursor
+
+        explicit PointRing(std::unique_ptr<Mapping> map);
+
+        auto slot_seq(std::uint64_t block) const -> std::uint64_t*;
+        auto slot_data(std::uint64_t block) const -> double*;
+
+      public:
+        PointRing(PointRing&&) noexcept;
+        auto operator=(PointRing&&) noexcept -> PointRing&;
+        ~PointRing();
+
+        /**
+         * @brief Ring in process memory, shared by the threads of one process
+         *
+         * @param[in] dim Coordinates per point
+         * @param[in] block_points Points per block
+         * @param[in] slots Number of slots (blocks in flight), at least 2
+         * @return PointRing
+         * @throw std::invalid_argument if dim or block_points is zero, or slots is below 2
+         */
+        static auto create_local(size_t dim, size_t block_points, size_t slots) -> PointRing;
+
+        /**
+         * @brief Create a ring in a new POSIX shared-memory object
+         *
+         * The object is unlinked when the returned ring is destroyed.
+         *
+         * @param[in] name Name of the object, e.g. "/sphere_n"
+         * @param[in] dim Coordinates per point
+         * @param[in] block_points Points per block
+         * @param[in] slots Number of slots (blocks in flight), at least 2
+         * @return PointRing
+         * @throw std::invalid_argument if dim or block_points is zero, or slots is below 2
+         * @throw std::runtime_error if the object exists or cannot be created
+         */
+        static auto create_shared(const std::string& name, size_t dim, size_t block_points,
+                                  size_t slots) -> PointRing;
+
+        /**
+         * @brief Attach to a ring created by `create_shared()` in another process
+         *
+         * Waits up to a second for a creator that is still initializing the
+         * ring.
+         *
+         * @param[in] name Name of the object
+         * @return PointRing
+         * @throw std::runtime_error if the object is missing, not a ring, or still
+         *        not initialized after the wait
+         */
+        static auto open_shared(const std::string& name) -> PointRing;
+
+        /**
+         * @brief Wait for the next free slot and return its buffer
+         *
+         * Producer only; follow with `commit_block()`.
+         *
+         * @return span<double> `block_points() * dim()` values
+         */
+        auto begin_block() -> span<double>;
+
+        /**
+         * @brief Publish the block filled after `begin_block()`
+         *
+         * @param[in] first_index Sequence index of the first point in the block
+         */
+        auto commit_block(unsigned long first_index) -> void;
+
+        /**
+         * @brief Generate one block with `gen` and publish it
+         *
+         * @tparam Gen Generator providing `size()`, `state()` and `pop_into()`.
+         * @param[in,out] gen The generator, `gen.size() == dim()`
+         */
+        template <typename Gen> auto produce(Gen& gen) -> void {
+            const auto first = gen.state().index + 1;
+            const auto buf = this->begin_block();
+            const auto dim = this->dim();
+            for (auto i = size_t{0}; i != buf.size(); i += dim) {
+                gen.pop_into(buf.subspan(i, dim));
+            }
+            this->commit_block(first);
+        }
+
+        /**
+         * @brief Mark the end of the stream; producer only
+         *
+         * Consumers receive the blocks published so far and then an empty
+         * result from `claim()`.
+         */
+        auto close() -> void;
+
+        /**
+         * @brief Claim the next unclaimed block, waiting until it is published
+         *
+         * A block previously held in `res` is released first.
+         *
+         * @param[in,out] res The claimed block
+         * @return bool false once the ring is closed and all blocks are claimed
+         */
+        auto claim(PointBlock& res) -> bool;
+
+        /**
+         * @brief Coordinates per point
+         * @return size_t
+         */
+        auto dim() const -> size_t;
+
+        /**
+         * @brief Points per block
+         * @return size_t
+         */
+        auto block_points() const -> size_t;
+
+        /**
+         * @brief Number of slots
+         * @return size_t
+         */
+        auto slots() const -> size_t;
+
+        friend class PointBlock;
+    };
+}  // namespace lds2
@@ -0,0 +1,142 @@
+#pragma once
+
+/** @file prefetch.hpp
+ *  @brief Sphere points generated ahead on a background thread, handed over lock-free.
+ */
+
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <span>     // for span
+
+#include <sphere_n/sincos.hpp>    // for Accuracy
+#include <sphere_n/sphere_n.hpp>  // for Inversion, Mapping
+
+namespace lds2 {
+    using std::span;
+
+    /**
+     * @brief How a side of the ring waits for the other
+     */
+    enum class WaitPolicy {
+        spin,   ///< busy-wait: lowest latency, burns a core while waiting
+        yield,  ///< busy-wait with `std::this_thread::yield()`
+        park,   ///< sleep in `std::atomic::wait()` until notified
+    };
+
+    /**
+     * @brief Options of `Prefetcher`
+     */
+    struct PrefetchOptions {
+        size_t depth = 8;                         ///< blocks in the ring
+        size_t block_points = 256;                ///< points per block
+        WaitPolicy wait = WaitPolicy::yield;      ///< waiting of both sides
+        Mapping mapping = Mapping::sphere;        ///< mapping of the sequence values
+        Inversion inversion = Inversion::interp;  ///< Tp inversion of `Mapping::sphere`
+        Accuracy accuracy = Accuracy::exact;      ///< accuracy of the sin/cos evaluations
+    };
+
+    /**
+     * @brief Sphere sequence generated ahead of its consumer by a producer thread
+     *
+     * A background thread generates blocks of `block_points` points (radical
+     * inverses as in `HaltonN`, mapped by `map_sphere_n()` or
+     * `map_cylind_n()`) into a ring of `depth` blocks. The ring has one
+     * producer and one consumer, so the handoff is two counters on their
+     * own cache lines, each written by one side only:
+     *
+     * @verbatim
+     *   producer:  wait head - tail < depth -> fill slot head % depth -> head += 1
+     *   consumer:  wait tail < head -> read slot tail % depth ... -> tail += 1
+     * @endverbatim
+     *
+     * Each side keeps a private copy of the other's counter and rereads it
+     * only when the copy says the ring is full or empty. `next()` is inline
+     * and touches no shared memory until its block is used up; then it
+     * releases the block and takes the next one.
+     *
+     * Backpressure: a full ring stops the producer, so at most `depth`
+     * blocks are generated ahead. `reseed()` bumps an epoch that the
+     * producer checks before every block; blocks of an older epoch are
+     * discarded by the consumer, so after `reseed(seed)` the next point is
+     * point seed + 1, exactly as for `SphereN`. The destructor stops and
+     * joins the producer.
+     *
+     * The object belongs to the consumer thread: `next()`, `next_into()`,
+     * `reseed()` and the destructor must be called from one thread at a
+     * time.
+     */
+    class Prefetcher {
+        struct Shared;
+        std::unique_ptr<Shared> shared;
+        const double* pos = nullptr;  ///< next point of the current block
+        const double* end = nullptr;  ///< end of the current block
+        size_t n_dim;
+        size_t n_stalls = 0;
+
+        auto refill() -> void;
+
+      public:
+        /**
+         * @brief Start the producer thread
+         *
+         * @param[in] base Bases of the m sequence values, as for `SphereN` or `CylindN`;
+         *                 the points lie on S^m (m >= 2)
+         * @param[in] opts Options
+         * @throw std::invalid_argument if `depth` or `block_points` is zero
+         */
+        explicit Prefetcher(span<const unsigned long> base, const PrefetchOptions& opts = {});
+        Prefetcher(const Prefetcher&) = delete;
+        auto operator=(const Prefetcher&) -> Prefetcher& = delete;
+        ~Prefetcher();
+
+        /**
+         * @brief Next point, valid until the following call of `next()` or `reseed()`
+         *
+         * @return span<const double> `dim()` coordinates
+         */
+        auto next() -> span<const double> {
+            if (this->pos == this->end) this->refill();
+            const auto res = span<const double>(this->pos, this->n_dim);
+            this->pos += this->n_dim;
+            return res;
+        }
+
+        /**
+         * @brief Next point into a caller-provided buffer
+         *
+         * @param[out] res Output buffer of `dim()` values
+         */
+        auto next_into(span<double> res) -> void {
+            const auto x = this->next();
+            for (auto i = size_t{0}; i != this->n_dim; ++i) {
+                res[i] = x[i];
+            }
+        }
+
+        /**
+         * @brief Restart the sequence after `seed` points
+         *
+         * Blocks generated ahead are dropped; the producer switches before
+         * its next block.
+         *
+         * @param[in] seed The seed value to reset to
+         */
+        auto reseed(unsigned long seed) -> void;
+
+        /**
+         * @brief Number of coordinates of each point
+         * @return size_t
+         */
+        auto dim() const -> size_t { return this->n_dim; }
+
+        /**
+         * @brief Times `next()` found the ring empty and had to wait for the producer
+         *
+         * A growing count means that the producer cannot keep up; a deeper
+         * ring only absorbs bursts.
+         *
+         * @return size_t
+         */
+        auto stalls() const -> size_t { return this->n_stalls; }
+    };
+}  // namespace lds2
@@ -0,0 +1,111 @@
+#pragma once
+
+/** @file quality.hpp
+ *  @brief Quality metrics of point sets on the unit sphere.
+ */
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <span>     // for span
+
+namespace lds2 {
+    using std::span;
+
+    /**
+     * @brief Parameters of the quality metrics
+     */
+    struct QualityOptions {
+        size_t threads = 0;       ///< worker threads, 0 for std::thread::hardware_concurrency()
+        size_t n_caps = 256;      ///< cap centers of the discrepancy estimate
+        size_t n_probes = 4096;   ///< probe points of the covering radius estimate
+        double riesz_s = 1.0;     ///< exponent s of the Riesz energy, 0 for the log energy
+        std::uint64_t seed = 1;   ///< seed of the cap centers and probe points
+    };
+
+    /**
+     * @brief All metrics of one point set
+     */
+    struct QualityReport {
+        double cap_discrepancy;  ///< see `cap_discrepancy()`
+        double riesz_energy;     ///< see `riesz_energy()`
+        double min_distance;     ///< see `min_distance()`
+        double covering_radius;  ///< see `covering_radius()`
+    };
+
+    /**
+     * @brief Spherical cap discrepancy, estimated over random cap centers
+     *
+     * For every center c the points are sorted by <x, c>, and the largest
+     * deviation between the fraction of points in the cap {x : <x, c> >= t}
+     * and its normalized area is taken over all thresholds t. The area of a
+     * cap of angular radius θ on S^m is the polar angle CDF of `tp_value()`
+     * with n = m - 1. The result is the maximum over the centers, a lower
+     * bound of the cap discrepancy. Cost O(n_caps N log N).
+     *
+     * @param[in] pts Row-major points on the unit sphere, a multiple of `dim` values
+     * @param[in] dim Coordinates per point (>= 2), i.e. points of S^(dim-1)
+     * @param[in] opts `threads`, `n_caps` and `seed` are used
+     * @return double
+     */
+    auto cap_discrepancy(span<const double> pts, size_t dim, const QualityOptions& opts = {})
+        -> double;
+
+    /**
+     * @brief Riesz s-energy, the sum over pairs i < j of |x_i - x_j|^-s
+     *
+     * For s == 0 the log energy, the sum of -log |x_i - x_j|, is returned
+     * instead. Exact O(N^2): the pairs are visited in blocks of rows against
+     * contiguous runs of columns of a coordinate-major copy, so the
+     * distance loop vectorizes; integer s is evaluated with multiplications
+     * and one square root. The partial sums of the row blocks are added in
+     * order, so the result does not depend on the number of threads.
+     *
+     * @param[in] pts Row-major points, a multiple of `dim` values
+     * @param[in] dim Coordinates per point
+     * @param[in] opts `threads` and `riesz_s` are used
+     * @return double
+     */
+    auto riesz_energy(span<const double> pts, size_t dim, const QualityOptions& opts = {})
+        -> double;
+
+    /**
+     * @brief Smallest distance between two points (separation)
+     *
+     * Exact, using nearest-neighbour queries on a uniform cell grid over the
+     * first (up to three) coordinates.
+     *
+     * @param[in] pts Row-major points, at least two, a multiple of `dim` values
+     * @param[in] dim Coordinates per point
+     * @param[in] opts `threads` is used
+     * @return double
+     */
+    auto min_distance(span<const double> pts, size_t dim, const QualityOptions& opts = {})
+        -> double;
+
+    /**
+     * @brief Covering radius, estimated over random probe points
+     *
+     * The largest distance from a uniform probe point on the sphere to its
+     * nearest point of the set, found with the same cell grid as
+     * `min_distance()`. A lower bound of the covering radius that tightens
+     * with `n_probes`.
+     *
+     * @param[in] pts Row-major points on the unit sphere, a multiple of `dim` values
+     * @param[in] dim Coordinates per point
+     * @param[in] opts `threads`, `n_probes` and `seed` are used
+     * @return double
+     */
+    auto covering_radius(span<const double> pts, size_t dim, const QualityOptions& opts = {})
+        -> double;
+
+    /**
+     * @brief All metrics at once, building the cell grid only once
+     *
+     * @param[in] pts Row-major points on the unit sphere, a multiple of `dim` values
+     * @param[in] dim Coordinates per point
+     * @param[in] opts Parameters of the metrics
+     * @return QualityReport
+     */
+    auto measure_quality(span<const double> pts, size_t dim, const QualityOptions& opts = {})
+        -> QualityReport;
+}  // namespace lds2
@@ -0,0 +1,152 @@
+#pragma once
+
+/** @file quantizer.hpp
+ *  @brief Nearest-codeword search over a growing set of points on the unit sphere.
+ */
+
+#include <cstddef>  // for size_t
+#include <span>     // for span
+#include <vector>   // for vector
+
+namespace lds2 {
+    using std::span;
+    using std::vector;
+
+    /**
+     * @brief Quantizer snapping vectors to the nearest of a codebook of unit vectors
+     *
+     * The codebook is indexed by a binary cap tree: every node stores a cap
+     * (center c, angular radius ρ) containing all codewords below it, and
+     * leaves hold up to LEAF_SIZE codewords in coordinate-major blocks. For a
+     * unit codeword x, |q - x|^2 = |q|^2 + 1 - 2 <q, x>, so the nearest
+     * codeword maximizes <q, x>, which over a cap is at most
+     * |q| cos(max(0, θ(q, c) - ρ)). The search descends into the more
+     * promising child first and skips caps whose bound cannot beat the best
+     * codeword found, which makes queries sub-linear for well-spread
+     * codebooks such as the points of `SphereN`.
+     *
+     * Codewords are inserted one at a time along the path of nearest child
+     * centers, widening the caps on the way; a full leaf is split around
+     * two far-apart pivots. The codebook can therefore grow while the
+     * generator keeps popping points, without rebuilding.
+     *
+     * @verbatim
+     *              (c, ρ)
+     *             /      \
+     *       (c0, ρ0)    (c1, ρ1)
+     *        /   \         |
+     *     leaf   leaf     leaf  <- up to LEAF_SIZE codewords each
+     * @endverbatim
+     */
+    class SphereQuantizer {
+      public:
+        /** @brief Capacity of a leaf */
+        static constexpr size_t LEAF_SIZE = 16;
+
+      private:
+        struct Node {
+            size_t center;      ///< offset of the center in `centers`
+            double cos_r;       ///< cos ρ
+            double sin_r;       ///< sin ρ
+            size_t child[2];    ///< children, or NONE for a leaf
+            size_t leaf;        ///< leaf block, for leaves
+        };
+
+        size_t n_dim;
+        vector<double> codebook;  ///< codewords in insertion order, row-major
+        vector<Node> nodes;
+        vector<double> centers;   ///< unit cap centers, row-major
+        vector<double> leaf_pts;  ///< per leaf: LEAF_SIZE x dim coordinate-major block
+        vector<size_t> leaf_ids;  ///< per leaf: LEAF_SIZE codeword indices
+        vector<size_t> leaf_len;  ///< per leaf: number of codewords
+
+        auto new_node(span<const double> center, size_t leaf) -> size_t;
+        auto new_leaf(span<const double> center) -> size_t;
+        auto widen(size_t node, const double* x) -> void;
+        auto append(size_t node, size_t id) -> void;
+        auto insert(size_t id) -> void;
+        auto split(size_t node) -> void;
+        auto search(const double* q, size_t node, double& best, size_t& best_id) const -> void;
+
+      public:
+        /**
+         * @brief Construct an empty quantizer
+         *
+         * @param[in] dim Coordinates per codeword (>= 2)
+         */
+        explicit SphereQuantizer(size_t dim);
+
+        /**
+         * @brief Construct a quantizer on a codebook
+         *
+         * @param[in] dim Coordinates per codeword (>= 2)
+         * @param[in] pts Row-major unit codewords, a multiple of `dim` values
+         */
+        SphereQuantizer(size_t dim, span<const double> pts) : SphereQuantizer(dim) {
+            this->add(pts);
+        }
+
+        /**
+         * @brief Append codewords; their indices continue from `size()`
+         *
+         * @param[in] pts Row-major unit codewords, a multiple of `dim()` values
+         */
+        auto add(span<const double> pts) -> void;
+
+        /**
+         * @brief Append the next n points of a generator
+         *
+         * @tparam Gen Generator providing `size()` and `pop_into()`, e.g. SphereN
+         * @param[in,out] gen The generator, `gen.size() == dim()`
+         * @param[in] n Number of points
+         */
+        template <typename Gen> auto grow(Gen& gen, size_t n) -> void {
+            vector<double> pts(n * this->n_dim);
+            for (auto i = size_t{0}; i != n; ++i) {
+                gen.pop_into(span<double>(pts).subspan(i * this->n_dim, this->n_dim));
+            }
+            this->add(pts);
+        }
+
+        /**
+         * @brief Index of the codeword nearest to q
+         *
+         * @param[in] q Query vector of `dim()` values, not necessarily unit
+         * @return size_t Index into the codebook, `size()` if it is empty
+         */
+        auto nearest(span<const double> q) const -> size_t;
+
+        /**
+         * @brief Indices of the codewords nearest to a batch of queries
+         *
+         * The index is read-only during queries, so batches may be split
+         * across threads.
+         *
+         * @param[in] queries Row-major query vectors, a multiple of `dim()` values
+         * @param[out] res One index per query
+         */
+        auto nearest_batch(span<const double> queries, span<size_t> res) const -> void;
+
+        /**
+         * @brief Codeword i
+         *
+         * @param[in] i Index into the codebook
+         * @return span<const double>
+         */
+        auto codeword(size_t i) const -> span<const double> {
+            return span<const double>(this->codebook).subspan(i * this->n_dim, this->n_dim);
+        }
+
+        /**
+         * @brief Number of codewords
+         * @return size_t
+         */
+        auto size() const -> size_t { return this->codebook.size() / this->n_dim; }
+
+        /**
+         * @brief Coordinates per codeword
+         * @return size_t
+         */
+        auto dim() const -> size_t { return this->n_dim; }
+    };
+}  // namespace lds2
@@ -0,0 +1,90 @@
+#pragma once
+
+/** @file radical_inverse.hpp
+ *  @brief Index-addressed Van der Corput values, digit expansions and strata.
+ */
+
+#include <cassert>  // for assert
+#include <cstddef>  // for size_t
+#include <span>     // for span
+
+namespace lds2 {
+    /**
+     * @brief Radical inverse of k in the given base
+     *
+     * Returns the k-th value of the Van der Corput sequence, i.e. the value
+     * that `VdCorput(base)` returns from `pop()` after `reseed(k - 1)`.
+     *
+     * @f[
+     *     \phi_b(k) = \sum_{j \ge 0} d_j\, b^{-j-1}, \quad k = \sum_{j \ge 0} d_j\, b^j
+     * @f]
+     *
+     * @param[in] k Index into the sequence
+     * @param[in] base The base (must be >= 2)
+     * @return double A value in [0, 1)
+     */
+    inline auto radical_inverse(unsigned long k, unsigned long base) -> double {
+        auto res = 0.0;
+        auto denom = 1.0;
+        const auto fbase = static_cast<double>(base);
+        while (k != 0) {
+            denom *= fbase;
+            res += static_cast<double>(k % base) / denom;
+            k /= base;
+        }
+        return res;
+    }
+
+    /**
+     * @brief Base-b digits of k, least significant first
+     *
+     * Writes at most `digits.size()` digits and zero-fills the rest.
+     *
+     * @param[in] k The number to expand
+     * @param[in] base The base (must be >= 2)
+     * @param[out] digits Output digits, `digits[j]` is the coefficient of b^j
+     * @return size_t Number of significant digits written
+     */
+    inline auto digit_expand(unsigned long k, unsigned long base, std::span<unsigned long> digits)
+        -> size_t {
+        size_t len = 0;
+        for (auto& d : digits) {
+            if (k != 0) ++len;
+            d = k % base;
+            k /= base;
+        }
+        return len;
+    }
+
+    /**
+     * @brief Stratum cell IDs of points of the unit hypercube
+     *
+     * Coordinate d is cut into `strata[d]` equal intervals and the interval
+     * indices are combined in mixed radix, coordinate 0 most significant, so
+     * the IDs run over [0, prod strata). With `strata[d] = base[d]^k_d` the
+     * cells are the elementary intervals of the Halton sequence in those
+     * bases: any prod strata consecutive points of the sequence fall into
+     * distinct cells. Combined with `inverse_sphere_n()` or
+     * `inverse_cylind_n()` this bins points on the sphere by the strata of
+     * the generator.
+     *
+     * @param[in] u Row-major input, `strata.size()` values in [0, 1] per point
+     * @param[in] strata Number of intervals per coordinate
+     * @param[out] ids One cell ID per point
+     */
+    inline auto cell_ids(std::span<const double> u, std::span<const unsigned long> strata,
+                         std::span<unsigned long> ids) -> void {
+        const auto dim = strata.size();
+        assert(u.size() == ids.size() * dim);
+        for (auto i = size_t{0}; i != ids.size(); ++i) {
+            const auto* ui = &u[i * dim];
+            auto id = 0UL;
+            for (auto d = size_t{0}; d != dim; ++d) {
+                // u == 1.0 and rounding above it stay in the last interval
+                const auto c = static_cast<unsigned long>(ui[d] * static_cast<double>(strata[d]));
+                id = id * strata[d] + ((c < strata[d]) ? c : strata[d] - 1);
+            }
+            ids[i] = id;
+        }
+    }
+}  // namespace lds2
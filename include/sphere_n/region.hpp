@@ -0,0 +1,180 @@
+#pragma once
+
+/** @file region.hpp
+ *  @brief Low-discrepancy points restricted to a spherical cap or band, without rejection.
+ */
+
+#include <cstddef>  // for size_t
+#include <span>     // for span
+#include <vector>   // for vector
+
+#include <sphere_n/gen_state.hpp>  // for GenState
+#include <sphere_n/halton_n.hpp>   // for HaltonN
+#include <sphere_n/sincos.hpp>     // for Accuracy
+#include <sphere_n/sphere_n.hpp>   // for Inversion, Mapping
+
+namespace lds2 {
+    using std::span;
+    using std::vector;
+
+    /**
+     * @brief Low-discrepancy sequence on a band of S^m around an arbitrary axis
+     *
+     * The band holds the points whose angle to `axis` lies in
+     * [theta_min, theta_max]; a cap is the band with theta_min = 0. The
+     * outermost level of both mappings turns the first sequence value u0
+     * into the angle to the pole e_m through a monotone CDF: the normalized
+     * Tp(m - 1) for `SphereN`, cos(angle) = 2 u0 - 1 for `CylindN`. Instead of
+     * generating the whole sphere and rejecting, u0 is remapped affinely
+     * onto [F(theta_min), F(theta_max)], so every point falls into the band
+     * and the points keep the low discrepancy of the sequence within it.
+     * A Householder reflection then carries the pole e_m onto `axis`.
+     *
+     * Point k is computed from its index alone (radical inverses of k, as in
+     * `HaltonN`), and batches are mapped by `map_sphere_n()` or
+     * `map_cylind_n()`, so a band costs the same per point as the full
+     * sphere. With the band [0, π] around e_m the points are those of the
+     * unrestricted generator.
+     *
+     * @verbatim
+     *   u0 in [0, 1) -> F(theta_min) + u0 (F(theta_max) - F(theta_min)) -> angle in band
+     *   [u0', u1, ..., u_{m-1}] -> map_sphere_n / map_cylind_n -> x around e_m
+     *   x -> x - 2 <v, x> v / <v, v>,  v = e_m - axis              -> x around axis
+     * @endverbatim
+     */
+    class RegionN {
+        HaltonN halton;
+        Mapping mapping;
+        Inversion inversion = Inversion::interp;
+        Accuracy accuracy = Accuracy::exact;
+        double theta_min;
+        double theta_max;
+        double u_lo = 0.0;     ///< remapped u0 at theta_min
+        double u_span = 1.0;   ///< remapped u0 width
+        vector<double> refl;   ///< Householder vector e_m - axis, empty if axis == e_m
+        double refl_scale;     ///< 2 / <refl, refl>
+
+        auto update_interval() -> void;
+        auto map_block(span<double> u, span<double> res) const -> void;
+
+      public:
+        /**
+         * @brief Construct a generator on a band
+         *
+         * @param[in] base Bases of the m sequence values, as for `SphereN` or `CylindN`;
+         *                 the points lie on S^m (m >= 2)
+         * @param[in] axis Axis of the band, m + 1 values, normalized internally
+         * @param[in] theta_min Smallest angle to the axis, in [0, π]
+         * @param[in] theta_max Largest angle to the axis, in [theta_min, π]
+         * @param[in] mapping Mapping of the sequence values
+         */
+        RegionN(span<const unsigned long> base, span<const double> axis, double theta_min,
+                double theta_max, Mapping mapping = Mapping::sphere);
+
+        /**
+         * @brief Construct a generator on the cap of angular radius theta around axis
+         *
+         * @param[in] base Bases of the m sequence values
+         * @param[in] axis Center of the cap, m + 1 values
+         * @param[in] theta Angular radius of the cap, in [0, π]
+         * @param[in] mapping Mapping of the sequence values
+         * @return RegionN
+         */
+        static auto cap(span<const unsigned long> base, span<const double> axis, double theta,
+                        Mapping mapping = Mapping::sphere) -> RegionN {
+            return RegionN(base, axis, 0.0, theta, mapping);
+        }
+
+        /**
+         * @brief Restart the sequence after `seed` points
+         *
+         * @param[in] seed The seed value to reset to
+         */
+        auto reseed(unsigned long seed) -> void { this->halton.reseed(seed); }
+
+        /**
+         * @brief Skip the next n points in O(1)
+         *
+         * @param[in] n Number of points to skip
+         */
+        auto skip(unsigned long n) -> void { this->halton.skip(n); }
+
+        /**
+         * @brief Select the Tp inversion method of `Mapping::sphere`
+         *
+         * The band limits are converted with the same method, so the points
+         * stay inside the band with either method.
+         *
+         * @param[in] mode Inversion method
+         */
+        auto set_inversion(Inversion mode) -> void;
+
+        /**
+         * @brief Select the accuracy policy of the sin/cos evaluations
+         *
+         * @param[in] acc Accuracy policy
+         */
+        auto set_accuracy(Accuracy acc) -> void { this->accuracy = acc; }
+
+        /**
+         * @brief Snapshot of the bases, the current position and the modes
+         *
+         * The axis and the band limits are not part of the state.
+         *
+         * @return GenState
+         */
+        auto state() const -> GenState {
+            auto res = this->halton.state();
+            res.inversion = this->inversion;
+            res.accuracy = this->accuracy;
+            return res;
+        }
+
+        /**
+         * @brief Copy the generator, including its current position
+         * @return RegionN
+         */
+        auto clone() const -> RegionN { return *this; }
+
+        /**
+         * @brief Share of the mapping's distribution that falls into the band
+         *
+         * For `Mapping::sphere` this is the area of the band relative to the
+         * whole sphere, the weight that turns averages over the band into
+         * integrals over the sphere.
+         *
+         * @return double
+         */
+        auto fraction() const -> double { return this->u_span; }
+
+        /**
+         * @brief Next point into a caller-provided buffer
+         *
+         * @param[out] res Output buffer of `size()` values
+         */
+        auto pop_into(span<double> res) -> void;
+
+        /**
+         * @brief Next point
+         * @return vector<double>
+         */
+        auto pop() -> vector<double> {
+            vector<double> res(this->size());
+            this->pop_into(res);
+            return res;
+        }
+
+        /**
+         * @brief Next `res.size() / size()` points
+         *
+         * @param[out] res Row-major output, `size()` values per point
+         */
+        auto pop_batch(span<double> res) -> void;
+
+        /**
+         * @brief Number of coordinates of each point
+         * @return size_t
+         */
+        auto size() const -> size_t { return this->halton.size() + 1; }
+    };
+}  // namespace lds2
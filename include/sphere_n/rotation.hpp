@@ -0,0 +1,209 @@
+#pragma once
+
+/** @file rotation.hpp
+ *  @brief Low-discrepancy rotations (unit quaternions and 3x3 matrices) built on Sphere3.
+ */
+
+#include <array>    // for array
+#include <cassert>  // for assert
+#include <cstddef>  // for size_t
+#include <span>     // for span
+
+#include <sphere_n/gen_state.hpp>  // for GenState, checked_bases
+#include <sphere_n/halton_n.hpp>   // for HaltonN
+#include <sphere_n/sincos.hpp>     // for Accuracy
+#include <sphere_n/sphere_n.hpp>   // for Inversion
+
+namespace lds2 {
+    using std::array;
+    using std::span;
+
+    /**
+     * @brief How the double cover of SO(3) by S^3 is resolved
+     *
+     * The unit quaternions q and -q describe the same rotation. Both methods
+     * return quaternions with w >= 0.
+     */
+    enum class Antipodal {
+        hemisphere,  ///< map the sequence onto the w >= 0 half of S^3, so no rotation repeats
+        fold,        ///< take the `Sphere3` points and flip the sign of those with w < 0
+    };
+
+    /**
+     * @brief Convert unit quaternions to rotation matrices
+     *
+     * The quaternions are stored as [x, y, z, w] (scalar last, the layout of
+     * `Sphere3` points) and the matrices as row-major 3x3 blocks:
+     *
+     * @f[
+     *     R = \begin{pmatrix}
+     *         1 - 2(y^2 + z^2) & 2(xy - zw) & 2(xz + yw) \\
+     *         2(xy + zw) & 1 - 2(x^2 + z^2) & 2(yz - xw) \\
+     *         2(xz - yw) & 2(yz + xw) & 1 - 2(x^2 + y^2)
+     *     \end{pmatrix}
+     * @f]
+     *
+     * Blocks of quaternions are transposed into coordinate-major scratch
+     * arrays first, so the arithmetic runs on fixed-length, unit-stride
+     * loops that vectorize.
+     *
+     * @param[in] quat Row-major quaternions, 4 values each
+     * @param[out] mat Row-major matrices, 9 values each
+     */
+    auto quat_to_matrix(span<const double> quat, span<double> mat) -> void;
+
+    /**
+     * @brief Low-discrepancy sequence of rotations in SO(3)
+     *
+     * Uniformly distributed points on S^3 are uniformly distributed unit
+     * quaternions, i.e. Haar-distributed rotations. This generator takes the
+     * points of `Sphere3` and resolves the antipodal identification q ~ -q:
+     * with `Antipodal::hemisphere` (the default) the outermost sequence
+     * value u0 is halved before the Tp inversion, which confines the polar
+     * angle to [0, π/2] (w = cos(xi) >= 0) while keeping its distribution,
+     * since the Tp(2) CDF is symmetric about π/2. Every rotation is then
+     * covered once by a low-discrepancy set, instead of twice by two
+     * interleaved ones whose near-antipodal pairs are near-duplicate
+     * rotations.
+     *
+     * Point k is computed from its index alone (radical inverses of k in the
+     * three bases, as in `HaltonN`, mapped by `map_sphere_n()`), so batches
+     * run the digit loops and the sin/cos evaluations over whole blocks.
+     *
+     * @verbatim
+     *   HaltonN [b0, b1, b2] -> (u0 / 2, u1, u2) -> map_sphere_n -> [x, y, z, w], w >= 0
+     *                                                                    |
+     *                                                                    v
+     *                                                    quat_to_matrix -> R (3x3)
+     * @endverbatim
+     */
+    class Rotation3 {
+        HaltonN halton;
+        Antipodal antipodal;
+        Inversion inversion = Inversion::interp;
+        Accuracy accuracy = Accuracy::exact;
+
+        auto map_block(span<double> u, span<double> res) const -> void;
+
+      public:
+        /**
+         * @brief Construct a new Rotation3 object
+         *
+         * @param[in] base Bases of the three sequence values, as for `Sphere3`
+         * @param[in] antipodal How q ~ -q is resolved
+         */
+        explicit Rotation3(span<const unsigned long> base,
+                           Antipodal antipodal = Antipodal::hemisphere)
+            : halton{base}, antipodal{antipodal} {
+            assert(base.size() == 3);
+        }
+
+        /**
+         * @brief Restore a Rotation3 object from a saved state
+         *
+         * @param[in] state State returned by `state()`, including the antipodal method
+         * @throw std::invalid_argument unless the state has 3 bases, all >= 2
+         */
+        explicit Rotation3(const GenState& state)
+            : Rotation3(checked_bases(state, "Rotation3", 3, 3), state.antipodal) {
+            this->reseed(state.index);
+            this->inversion = state.inversion;
+            this->accuracy = state.accuracy;
+        }
+
+        /**
+         * @brief Restart the sequence after `seed` rotations
+         *
+         * @param[in] seed The seed value to reset to
+         */
+        auto reseed(unsigned long seed) -> void { this->halton.reseed(seed); }
+
+        /**
+         * @brief Skip the next n rotations in O(1)
+         *
+         * @param[in] n Number of rotations to skip
+         */
+        auto skip(unsigned long n) -> void { this->halton.skip(n); }
+
+        /**
+         * @brief Select the Tp inversion method, see `Sphere3::set_inversion()`
+         *
+         * @param[in] mode Inversion method
+         */
+        auto set_inversion(Inversion mode) -> void { this->inversion = mode; }
+
+        /**
+         * @brief Select the accuracy policy of the sin/cos evaluations
+         *
+         * @param[in] acc Accuracy policy
+         */
+        auto set_accuracy(Accuracy acc) -> void { this->accuracy = acc; }
+
+        /**
+         * @brief Snapshot of the bases, the current position and the modes
+         * @return GenState
+         */
+        auto state() const -> GenState {
+            auto res = this->halton.state();
+            res.inversion = this->inversion;
+            res.accuracy = this->accuracy;
+            res.antipodal = this->antipodal;
+            return res;
+        }
+
+        /**
+         * @brief Copy the generator, including its current position
+         * @return Rotation3
+         */
+        auto clone() const -> Rotation3 { return *this; }
+
+        /**
+         * @brief Next rotation as a unit quaternion [x, y, z, w], w >= 0
+         * @return array<double, 4>
+         */
+        auto pop() -> array<double, 4> {
+            array<double, 4> res;
+            this->pop_into(res);
+            return res;
+        }
+
+        /**
+         * @brief Next rotation as a row-major 3x3 matrix
+         * @return array<double, 9>
+         */
+        auto pop_matrix() -> array<double, 9> {
+            array<double, 9> res;
+            this->pop_batch_matrix(res);
+            return res;
+        }
+
+        /**
+         * @brief Next rotation into a caller-provided buffer of 4 values
+         *
+         * @param[out] res Output quaternion [x, y, z, w]
+         */
+        auto pop_into(span<double> res) -> void;
+
+        /**
+         * @brief Next `res.size() / 4` rotations as quaternions
+         *
+         * @param[out] res Row-major output, 4 values per rotation
+         */
+        auto pop_batch(span<double> res) -> void;
+
+        /**
+         * @brief Next `res.size() / 9` rotations as matrices
+         *
+         * Same rotations as `pop_batch()`, converted by `quat_to_matrix()`.
+         *
+         * @param[out] res Row-major output, 9 values per rotation
+         */
+        auto pop_batch_matrix(span<double> res) -> void;
+
+        /**
+         * @brief Number of coordinates of each quaternion
+         * @return size_t
+         */
+        static constexpr auto size() -> size_t { return 4; }
+    };
+}  // namespace lds2
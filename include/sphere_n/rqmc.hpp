@@ -0,0 +1,215 @@
+#pragma once
+
+/** @file rqmc.hpp
+ *  @brief Randomized quasi-Monte Carlo replicates of the sphere sequences.
+ */
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <span>     // for span
+#include <vector>   // for vector
+
+namespace lds2 {
+    using std::span;
+    using std::vector;
+
+    /**
+     * @brief Randomization applied to the Van der Corput values
+     */
+    enum class Randomization {
+        digit_scramble,  ///< random affine permutation (a d + s) mod b of every digit position
+        random_shift,    ///< Cranley-Patterson rotation (u + s) mod 1
+    };
+
+    /**
+     * @brief R independently randomized replicates of several Van der Corput sequences
+     *
+     * For index k and bases b_0, ..., b_{m-1}, `values()` produces R rows of m
+     * randomized values. The digit expansion of k is computed once per base
+     * and shared by all replicates; only the per-replicate permutation or
+     * shift differs. All randomization parameters are drawn from a
+     * `std::mt19937_64` seeded with `seed`, so the replicates are
+     * reproducible across platforms.
+     *
+     * With `Randomization::digit_scramble` every digit position j of base b
+     * gets its own permutation d -> (a_j d + s_j) mod b with gcd(a_j, b) = 1,
+     * applied to enough digits to reach double precision. Each replicate is
+     * uniformly distributed and keeps the stratification of the original
+     * sequence: the first b^k points still fall one per interval of width
+     * b^-k.
+     *
+     * @verbatim
+     *   k --digits--> [d_0, d_1, ..., d_J]     (once per base)
+     *                   |    |          |
+     *                   v    v          v
+     *   replicate r:   pi_0 pi_1  ...  pi_J  -> u_r = sum pi_j(d_j) b^{-j-1}
+     * @endverbatim
+     */
+    class RandomizedVdCorput {
+        vector<unsigned long> base;
+        size_t n_rep;
+        Randomization kind;
+        vector<size_t> n_digits;       ///< digits used for each base
+        vector<size_t> offset;         ///< start of each base in `mult`/`add`
+        vector<std::uint64_t> mult;    ///< a_j per (base, digit, replicate)
+        vector<std::uint64_t> add;     ///< s_j per (base, digit, replicate)
+        vector<double> shift;          ///< shift per (base, replicate)
+        vector<unsigned long> digits;  ///< scratch digit expansion
+        vector<double> acc;            ///< scratch per-replicate accumulator
+
+      public:
+        /**
+         * @brief Construct the randomized replicates
+         *
+         * @param[in] base Bases of the Van der Corput sequences
+         * @param[in] replicates Number of independent replicates R
+         * @param[in] seed Seed of the randomization
+         * @param[in] kind Randomization method
+         */
+        RandomizedVdCorput(span<const unsigned long> base, size_t replicates, std::uint64_t seed,
+                           Randomization kind = Randomization::digit_scramble);
+
+        /**
+         * @brief Randomized values for sequence index k
+         *
+         * @param[in] k Index into the sequence
+         * @param[out] u Row-major output, `replicates() * dims()` values in [0, 1)
+         */
+        auto values(unsigned long k, span<double> u) -> void;
+
+        /**
+         * @brief Number of bases
+         * @return size_t
+         */
+        auto dims() const -> size_t { return this->base.size(); }
+
+        /**
+         * @brief Number of replicates
+         * @return size_t
+         */
+        auto replicates() const -> size_t { return this->n_rep; }
+    };
+
+    /**
+     * @brief Randomized replicates of the SphereN sequence
+     *
+     * Each call to `pop_batch()` generates the next point of all R replicates
+     * in one pass: the randomized values of all replicates are produced
+     * together and mapped with `map_sphere_n()`, which looks up each Tp table
+     * once for the whole batch. Replicate r of point k is the k-th point of
+     * `SphereN(base)` with randomized Van der Corput values.
+     */
+    class RandomizedSphereN {
+        size_t m;
+        unsigned long count = 0;
+        RandomizedVdCorput rvdc;
+        vector<double> u;
+
+      public:
+        /**
+         * @brief Construct a new RandomizedSphereN object
+         *
+         * @param[in] base Bases as for `SphereN` (at least 3)
+         * @param[in] replicates Number of independent replicates R
+         * @param[in] seed Seed of the randomization
+         * @param[in] kind Randomization method
+         */
+        RandomizedSphereN(span<const unsigned long> base, size_t replicates, std::uint64_t seed,
+                          Randomization kind = Randomization::digit_scramble);
+
+        /**
+         * @brief Generate the next point of every replicate
+         *
+         * @param[out] res Row-major output, `replicates() * size()` coordinates
+         */
+        auto pop_batch(span<double> res) -> void;
+
+        /**
+         * @brief Generate the next point of every replicate
+         * @return vector<double> Row-major, `replicates() * size()` coordinates
+         */
+        auto pop() -> vector<double> {
+            vector<double> res(this->replicates() * this->size());
+            this->pop_batch(res);
+            return res;
+        }
+
+        /**
+         * @brief Reset the sequence position; the randomization is kept
+         * @param[in] seed The seed value to reset to
+         */
+        auto reseed(unsigned long seed) -> void { this->count = seed; }
+
+        /**
+         * @brief Number of coordinates of each generated point
+         * @return size_t
+         */
+        auto size() const -> size_t { return this->m + 1; }
+
+        /**
+         * @brief Number of replicates
+         * @return size_t
+         */
+        auto replicates() const -> size_t { return this->rvdc.replicates(); }
+    };
+
+    /**
+     * @brief Randomized replicates of the CylindN sequence
+     *
+     * Same as `RandomizedSphereN`, using the cylindrical mapping of
+     * `CylindN`.
+     */
+    class RandomizedCylindN {
+        size_t m;
+        unsigned long count = 0;
+        RandomizedVdCorput rvdc;
+        vector<double> u;
+
+      public:
+        /**
+         * @brief Construct a new RandomizedCylindN object
+         *
+         * @param[in] base Bases as for `CylindN` (at least 2)
+         * @param[in] replicates Number of independent replicates R
+         * @param[in] seed Seed of the randomization
+         * @param[in] kind Randomization method
+         */
+        RandomizedCylindN(span<const unsigned long> base, size_t replicates, std::uint64_t seed,
+                          Randomization kind = Randomization::digit_scramble);
+
+        /**
+         * @brief Generate the next point of every replicate
+         *
+         * @param[out] res Row-major output, `replicates() * size()` coordinates
+         */
+        auto pop_batch(span<double> res) -> void;
+
+        /**
+         * @brief Generate the next point of every replicate
+         * @return vector<double> Row-major, `replicates() * size()` coordinates
+         */
+        auto pop() -> vector<double> {
+            vector<double> res(this->replicates() * this->size());
+            this->pop_batch(res);
+            return res;
+        }
+
+        /**
+         * @brief Reset the sequence position; the randomization is kept
+         * @param[in] seed The seed value to reset to
+         */
+        auto reseed(unsigned long seed) -> void { this->count = seed; }
+
+        /**
+         * @brief Number of coordinates of each generated point
+         * @return size_t
+         */
+        auto size() const -> size_t { return this->m + 1; }
+
+        /**
+         * @brief Number of replicates
+         * @return size_t
+         */
+        auto replicates() const -> size_t { return this->rvdc.replicates(); }
+    };
+}  // namespace lds2
@@ -0,0 +1,187 @@
+#pragma once
+
+/** @file sincos.hpp
+ *  @brief Inlined polynomial sin/cos kernels with selectable accuracy.
+ *
+ *  The kernels are branch-free (quadrant selection by sign-bit and blend
+ *  operations), so a loop over `sin_cos()` vectorizes. They rely on IEEE
+ *  round-to-nearest arithmetic and must not be compiled with `-ffast-math`.
+ */
+
+#include <array>    // for array
+#include <bit>      // for bit_cast
+#include <cassert>  // for assert
+#include <cmath>    // for sin, cos
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <limits>   // for numeric_limits
+#include <span>     // for span
+
+/** @brief Forces inlining where the compiler supports it (the kernels must inline to vectorize) */
+#if defined(__GNUC__)
+#    define SPHERE_N_ALWAYS_INLINE [[gnu::always_inline]]
+#else
+#    define SPHERE_N_ALWAYS_INLINE
+#endif
+
+namespace lds2 {
+    /**
+     * @brief Accuracy policy of the sin/cos evaluations in the generators
+     */
+    enum class Accuracy {
+        exact,  ///< std::sin and std::cos (default)
+        high,   ///< polynomial kernel, absolute error below 1e-12
+        fast,   ///< polynomial kernel, absolute error below 1e-7
+    };
+
+    /** @brief Largest |x| accepted by the polynomial kernels */
+    constexpr double SINCOS_MAX_ARG = 1.0e6;
+
+    /**
+     * @brief Advertised bound of the absolute error of `sin_cos()`
+     *
+     * Holds for |x| <= SINCOS_MAX_ARG.
+     *
+     * @param[in] acc Accuracy policy
+     * @return double
+     */
+    constexpr auto sincos_max_error(Accuracy acc) -> double {
+        switch (acc) {
+            case Accuracy::high:
+                return 1.0e-12;
+            case Accuracy::fast:
+                return 1.0e-7;
+            default:
+                return std::numeric_limits<double>::epsilon();
+        }
+    }
+
+    namespace detail {
+        /** @brief Taylor coefficients of sin(r) / r in powers of r^2 */
+        constexpr std::array<double, 8> SIN_COEF{
+            1.0,           -1.0 / 6.0,           1.0 / 120.0,           -1.0 / 5040.0,
+            1.0 / 362880.0, -1.0 / 39916800.0, 1.0 / 6227020800.0, -1.0 / 1307674368000.0,
+        };
+
+        /** @brief Taylor coefficients of cos(r) in powers of r^2 */
+        constexpr std::array<double, 8> COS_COEF{
+            1.0,          -1.0 / 2.0,           1.0 / 24.0,           -1.0 / 720.0,
+            1.0 / 40320.0, -1.0 / 3628800.0, 1.0 / 479001600.0, -1.0 / 87178291200.0,
+        };
+
+        /**
+         * @brief sin(x) and cos(x) with NS and NC polynomial terms
+         *
+         * x is reduced to r in [-π/4, π/4] with x = r + k π/2 (Cody-Waite,
+         * exact for |x| <= SINCOS_MAX_ARG), the truncated series are evaluated
+         * by Horner's scheme and the quadrant k mod 4 swaps and negates the
+         * results. With |r| <= π/4 the truncation error is below
+         * (π/4)^(2 NS + 1) / (2 NS + 1)! for sin and (π/4)^(2 NC) / (2 NC)!
+         * for cos.
+         *
+         * @verbatim
+         *   k mod 4:     0      1      2      3
+         *   sin(x)   sin(r)  cos(r) -sin(r) -cos(r)
+         *   cos(x)   cos(r) -sin(r) -cos(r)  sin(r)
+         * @endverbatim
+         *
+         * @tparam NS Number of terms of the sine series
+         * @tparam NC Number of terms of the cosine series
+         */
+        template <size_t NS, size_t NC>
+        SPHERE_N_ALWAYS_INLINE inline auto sincos_poly(double x, double& s, double& c) -> void {
+            constexpr double TWO_OVER_PI = 0.63661977236758134308;
+            constexpr double PIO2_HI = 1.57079632673412561417e+00;  // first 33 bits of π/2
+            constexpr double PIO2_LO = 6.07710050650619224932e-11;  // π/2 - PIO2_HI
+            constexpr double ROUND = 0x1.8p52;  // adding it rounds to an integer
+            constexpr std::uint64_t SIGN = std::uint64_t{1} << 63U;
+
+            const auto kr = x * TWO_OVER_PI + ROUND;
+            const auto q = std::bit_cast<std::uint64_t>(kr);  // k mod 2^51 in the low bits
+            const auto k = kr - ROUND;
+            const auto r = (x - k * PIO2_HI) - k * PIO2_LO;
+            const auto r2 = r * r;
+
+            auto ps = SIN_COEF[NS - 1];
+            for (auto i = NS - 1; i-- != 0;) {
+                ps = ps * r2 + SIN_COEF[i];
+            }
+            auto pc = COS_COEF[NC - 1];
+            for (auto i = NC - 1; i-- != 0;) {
+                pc = pc * r2 + COS_COEF[i];
+            }
+            const auto sr = r * ps;
+            const auto swap = (q & 1U) != 0;
+            const auto sv = std::bit_cast<std::uint64_t>(swap ? pc : sr);
+            const auto cv = std::bit_cast<std::uint64_t>(swap ? sr : pc);
+            s = std::bit_cast<double>(sv ^ ((q << 62U) & SIGN));
+            c = std::bit_cast<double>(cv ^ (((q + 1U) << 62U) & SIGN));
+        }
+
+        /**
+         * @brief Element-wise `sincos_poly` over a batch
+         */
+        template <size_t NS, size_t NC>
+        SPHERE_N_ALWAYS_INLINE inline auto sincos_poly(std::span<const double> x,
+                                                       std::span<double> s, std::span<double> c)
+            -> void {
+            const auto len = x.size();
+            for (auto i = size_t{0}; i != len; ++i) {
+                sincos_poly<NS, NC>(x[i], s[i], c[i]);
+            }
+        }
+    }  // namespace detail
+
+    /**
+     * @brief sin(x) and cos(x) under an accuracy policy
+     *
+     * @param[in] acc Accuracy policy
+     * @param[in] x The angle, |x| <= SINCOS_MAX_ARG unless `acc` is exact
+     * @param[out] s sin(x)
+     * @param[out] c cos(x)
+     */
+    inline auto sin_cos(Accuracy acc, double x, double& s, double& c) -> void {
+        switch (acc) {
+            case Accuracy::high:
+                detail::sincos_poly<7, 7>(x, s, c);
+                break;
+            case Accuracy::fast:
+                detail::sincos_poly<5, 5>(x, s, c);
+                break;
+            default:
+                s = std::sin(x);
+                c = std::cos(x);
+        }
+    }
+
+    /**
+     * @brief sin and cos of a batch of angles under an accuracy policy
+     *
+     * The policy is dispatched once per batch, and the loop over the
+     * polynomial kernel is free of branches and calls. It is always
+     * inlined, so kernels compiled for a wider instruction set (see
+     * `select_map_kernel()`) vectorize it at their own width.
+     *
+     * @param[in] acc Accuracy policy
+     * @param[in] x The angles, |x| <= SINCOS_MAX_ARG unless `acc` is exact
+     * @param[out] s sin(x), same size as x
+     * @param[out] c cos(x), same size as x
+     */
+    SPHERE_N_ALWAYS_INLINE inline auto sin_cos(Accuracy acc, std::span<const double> x,
+                                               std::span<double> s, std::span<double> c) -> void {
+        assert(s.size() == x.size() && c.size() == x.size());
+        switch (acc) {
+            case Accuracy::high:
+                detail::sincos_poly<7, 7>(x, s, c);
+                break;
+            case Accuracy::fast:
+                detail::sincos_poly<5, 5>(x, s, c);
+                break;
+            default:
+                for (auto i = size_t{0}; i != x.size(); ++i) {
+                    s[i] = std::sin(x[i]);
+                    c[i] = std::cos(x[i]);
+                }
+        }
+    }
+}  // namespace lds2
@@ -4,20 +4,26 @@
  *  @brief S(3) and S(n) sphere sequence generators using low-discrepancy sequences.
  */
 
-#include <array>    // for array
-#include <cassert>  // for assert
-#include <cstddef>  // for size_t
-#include <memory>   // for unique_ptr, make_unique
-#include <span>     // for span
+#include <array>            // for array
+#include <cassert>          // for assert
+#include <cstddef>          // for size_t
+#include <memory>           // for unique_ptr
+#include <memory_resource>  // for memory_resource, polymorphic_allocator
+#include <span>             // for span
 // #include <type_traits>  // for move, remove_reference<>::type
 #include <variant>  // for visit, variant
 #include <vector>   // for vector
 // #include <xtensor/xarray.hpp>  // for xtensor, xarray
 
-#include <ldsgen/lds.hpp>  // for VdCorput, Sphere
+#include <ldsgen/lds.hpp>          // for VdCorput, Sphere
+#include <sphere_n/gen_state.hpp>  // for GenState, checked_bases
+#include <sphere_n/pmr.hpp>        // for PmrPtr, make_pmr
+#include <sphere_n/sincos.hpp>     // for Accuracy
 
 namespace lds2 {
     const size_t N_POINTS = 300;
+    /** @brief Number of grid points of the coarse tables used by `Inversion::newton` */
+    const size_t N_COARSE = 33;
     // using Arr = xt::xarray<double, xt::layout_type::row_major>;
     using ldsgen::Sphere;
     using ldsgen::VdCorput;
@@ -25,6 +31,58 @@ namespace lds2 {
     using std::span;
     using std::vector;
 
+    /**
+     * @brief Method used to invert the Tp CDF of each level
+     */
+    enum class Inversion {
+        interp,  ///< linear interpolation in the N_POINTS-point Tp table (default)
+        newton,  ///< coarse-table guess refined by Halley steps; table-free for Sphere3
+    };
+
+    /**
+     * @brief Value of the Tp function
+     *
+     * Tp(n) is the antiderivative of sin^n(x), normalized by the recursion
+     * Tp(n) = ((n-1) * Tp(n-2) - cos(x) * sin(x)^(n-1)) / n with Tp(0) = x and
+     * Tp(1) = -cos(x). The polar angle of a uniform point on S^(n+1) has the
+     * CDF (Tp(n)(x) - Tp(n)(0)) / (Tp(n)(π) - Tp(n)(0)).
+     *
+     * @param[in] n Dimension parameter
+     * @param[in] x Angle in [0, π]
+     * @return double
+     */
+    auto tp_value(size_t n, double x) -> double;
+
+    /**
+     * @brief Inverse of the normalized Tp CDF
+     *
+     * Returns the angle xi in [0, π] whose normalized CDF value is u; this is
+     * the angle that `SphereN` (n >= 3) and `Sphere3` (n == 2) derive from a
+     * sequence value u.
+     *
+     * @param[in] n Dimension parameter
+     * @param[in] u Value in [0, 1]
+     * @param[in] mode Inversion method
+     * @return double
+     */
+    auto tp_inverse(size_t n, double u, Inversion mode = Inversion::interp) -> double;
+
+    /**
+     * @brief Normalized Tp CDF, the inverse of `tp_inverse()`
+     *
+     * Returns (Tp(n)(xi) - Tp(n)(0)) / (Tp(n)(π) - Tp(n)(0)), the share of a
+     * uniform measure on S^(n+1) within the polar angle xi. With
+     * `Inversion::interp` the value is read from the same table as
+     * `tp_inverse()` uses, so the two functions invert each other exactly
+     * up to rounding.
+     *
+     * @param[in] n Dimension parameter
+     * @param[in] xi Angle in [0, π]
+     * @param[in] mode Inversion method
+     * @return double
+     */
+    auto tp_cdf(size_t n, double xi, Inversion mode = Inversion::interp) -> double;
+
     /**
      * @brief Convert a std::array to a std::vector.
      * @tparam T Element type.
@@ -78,6 +136,10 @@ namespace lds2 {
      * @endverbatim
      */
     class Sphere3 {
+        array<unsigned long, 3> bases;
+        unsigned long count = 0;
+        Inversion inversion = Inversion::interp;
+        Accuracy accuracy = Accuracy::exact;
         VdCorput vdc;
         Sphere sphere2;
         // Arr tp;
@@ -106,6 +168,18 @@ namespace lds2 {
          */
         explicit Sphere3(span<const unsigned long> base);
 
+        /**
+         * @brief Restore a Sphere3 object from a saved state
+         *
+         * @param[in] state State returned by `state()`
+         * @throw std::invalid_argument unless the state has 3 bases, all >= 2
+         */
+        explicit Sphere3(const GenState& state) : Sphere3(checked_bases(state, "Sphere3", 3, 3)) {
+            this->reseed(state.index);
+            this->set_inversion(state.inversion);
+            this->set_accuracy(state.accuracy);
+        }
+
         /**
          * @brief reseed
          *
@@ -117,10 +191,45 @@ namespace lds2 {
          * @param[in] seed
          */
         auto reseed(unsigned long seed) -> void {
+            this->count = seed;
             this->vdc.reseed(seed);
             this->sphere2.reseed(seed);
         }
 
+        /**
+         * @brief Copy the generator, including its current position
+         * @return Sphere3
+         */
+        auto clone() const -> Sphere3 { return *this; }
+
+        /**
+         * @brief Select the Tp inversion method
+         *
+         * With `Inversion::newton` the angle is computed without any table,
+         * to near machine precision.
+         *
+         * @param[in] mode Inversion method
+         */
+        auto set_inversion(Inversion mode) -> void { this->inversion = mode; }
+
+        /**
+         * @brief Select the accuracy policy of sin(xi) and cos(xi)
+         *
+         * The inner S^2 point comes from `ldsgen::Sphere` and is unaffected.
+         *
+         * @param[in] acc Accuracy policy
+         */
+        auto set_accuracy(Accuracy acc) -> void { this->accuracy = acc; }
+
+        /**
+         * @brief Snapshot of the bases, the current position and the modes
+         * @return GenState
+         */
+        auto state() const -> GenState {
+            return GenState{{this->bases.begin(), this->bases.end()}, this->count, this->inversion,
+                            this->accuracy};
+        }
+
         /**
          * @brief pop
          *
@@ -152,11 +261,44 @@ namespace lds2 {
          * @endverbatim
          */
         auto pop() -> array<double, 4>;
+
+        /**
+         * @brief Generate the next point into a caller-provided buffer
+         *
+         * Same as `pop()`, but writes the 4 coordinates into `res` instead of
+         * returning them, so that no allocation takes place.
+         *
+         * @param[out] res Output buffer of size 4
+         */
+        auto pop_into(span<double> res) -> void;
+
+        /**
+         * @brief Generate the next point together with its inner S^2 point
+         *
+         * `res[0]` receives the S^2 point of the nested `ldsgen::Sphere`
+         * (3 values) and `res[1]` the S^3 point (4 values), the same as
+         * `pop_into()` writes.
+         *
+         * @param[out] res Two output buffers
+         */
+        auto pop_nested(span<const span<double>> res) -> void;
+
+        /**
+         * @brief Number of coordinates of each generated point
+         * @return size_t
+         */
+        static constexpr auto size() -> size_t { return 4; }
     };
 
     class SphereN;
 
-    using SphereVariant = std::variant<std::unique_ptr<Sphere3>, std::unique_ptr<SphereN>>;
+    /**
+     * @brief Variant type for recursive sphere generator dispatching.
+     *
+     * Holds either a Sphere3 (base case) or a SphereN (recursive case). The
+     * nodes are allocated from the memory resource of the enclosing SphereN.
+     */
+    using SphereVariant = std::variant<PmrPtr<Sphere3>, PmrPtr<SphereN>>;
 
     /**
      * @brief S(n) sequence generator
@@ -214,11 +356,20 @@ namespace lds2 {
      */
     class SphereN {
         size_t n;
+        unsigned long b;
+        unsigned long count = 0;
+        Inversion inversion = Inversion::interp;
+        Accuracy accuracy = Accuracy::exact;
         VdCorput vdc;
         SphereVariant s_gen;
         // Arr tp;
 
+        auto collect_bases(vector<unsigned long>& res) const -> void;
+
       public:
+        /** @brief Allocator used for the nested generators and `pop(mr)` results. */
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
         /**
          * @brief Construct a new Sphere N object
          *
@@ -228,7 +379,12 @@ namespace lds2 {
          * keyword indicates that this constructor can only be used for explicit
          * construction and not for implicit conversions.
          *
+         * All nested generators are allocated from `alloc`, so a
+         * `std::pmr::monotonic_buffer_resource` holds the whole generator tree
+         * in one block.
+         *
          * @param[in] base Span containing base numbers for sequence generation
+         * @param[in] alloc Allocator for the nested generators
          *
          * @verbatim
          *   Base: [b0, b1, b2, ..., bn]
@@ -240,7 +396,30 @@ namespace lds2 {
          *       n-sphere point
          * @endverbatim
          */
-        explicit SphereN(span<const unsigned long> base);
+        explicit SphereN(span<const unsigned long> base, const allocator_type& alloc = {});
+
+        /**
+         * @brief Restore a SphereN object from a saved state
+         *
+         * Rebuilds the generator from the saved bases and seeks every level to
+         * the saved index, without replaying `pop()`.
+         *
+         * @param[in] state State returned by `state()`
+         * @param[in] alloc Allocator for the nested generators
+         * @throw std::invalid_argument unless the state has at least 4 bases, all >= 2
+         */
+        explicit SphereN(const GenState& state, const allocator_type& alloc = {});
+
+        /**
+         * @brief Allocator-extended copy constructor
+         *
+         * Deep-copies the nested generators into `alloc`, including their
+         * current position. The cost is O(n).
+         *
+         * @param[in] other The generator to copy
+         * @param[in] alloc Allocator for the nested generators
+         */
+        SphereN(const SphereN& other, const allocator_type& alloc);
 
         /**
          * @brief pop
@@ -273,11 +452,287 @@ namespace lds2 {
          */
         auto pop() -> vector<double>;
 
+        /**
+         * @brief Generate the next point into a memory-resource backed vector
+         *
+         * @param[in] mr The memory resource for the result
+         * @return std::pmr::vector<double> An (n+1)-dimensional point
+         */
+        auto pop(std::pmr::memory_resource* mr) -> std::pmr::vector<double>;
+
+        /**
+         * @brief Generate the next point into a caller-provided buffer
+         *
+         * The nested generators write their coordinates directly into the
+         * leading part of `res`, so no temporary vectors are created.
+         *
+         * @param[in,out] res Output buffer of size `size()`
+         */
+        auto pop_into(span<double> res) -> void;
+
+        /**
+         * @brief Generate the next point and the points of all nested levels
+         *
+         * Every level of the generator builds its point from the point of the
+         * level below, so one evaluation yields a point on each of S^2, S^3,
+         * ..., S^(size()-1). `res[j]` receives the S^(j+2) point (j + 3
+         * values) and `res.back()` the point `pop_into()` would write. The
+         * S^k point is the point of a generator on the last k bases at the
+         * same index, e.g. `SphereN(base.last(k))` for k >= 4, so a sweep over
+         * dimensions costs one traversal instead of one generator per
+         * dimension.
+         *
+         * @verbatim
+         *   bases [b0, b1, ..., b_{m-3}, b_{m-2}, b_{m-1}]
+         *                                \______ S^2 ___/   res[0]
+         *                       \__________ S^3 ________/   res[1]
+         *          ...
+         *         \______________ S^m (this) ___________/   res[m-2]
+         * @endverbatim
+         *
+         * @param[out] res `levels()` output buffers of sizes 3, 4, ..., `size()`
+         */
+        auto pop_nested(span<const span<double>> res) -> void;
+
+        /**
+         * @brief Number of levels written by `pop_nested()`
+         * @return size_t
+         */
+        auto levels() const -> size_t { return this->n; }
+
+        /**
+         * @brief Number of coordinates of each generated point
+         * @return size_t
+         */
+        auto size() const -> size_t { return this->n + 2; }
+
+        /**
+         * @brief Get the allocator used for the nested generators
+         * @return allocator_type
+         */
+        auto get_allocator() const -> allocator_type;
+
+        /**
+         * @brief Copy the generator, including its current position
+         *
+         * The copy allocates from the same memory resource. The cost is O(n).
+         *
+         * @return SphereN
+         */
+        auto clone() const -> SphereN { return SphereN(*this, this->get_allocator()); }
+
+        /**
+         * @brief Snapshot of the bases, the current position and the modes
+         * @return GenState
+         */
+        auto state() const -> GenState;
+
+        /**
+         * @brief Select the Tp inversion method of this and all nested levels
+         *
+         * `Inversion::newton` starts from a N_COARSE-point table and refines
+         * the angle with Halley steps using the closed-form derivative
+         * sin^n(x), giving near machine-precision coordinates.
+         *
+         * @param[in] mode Inversion method
+         */
+        auto set_inversion(Inversion mode) -> void;
+
+        /**
+         * @brief Select the accuracy policy of this and all nested levels
+         *
+         * `Accuracy::high` and `Accuracy::fast` replace the libm calls for
+         * sin(xi) and cos(xi) by the inlined kernels of sincos.hpp, with the
+         * absolute error per coordinate bounded by `sincos_max_error()`
+         * times the number of levels.
+         *
+         * @param[in] acc Accuracy policy
+         */
+        auto set_accuracy(Accuracy acc) -> void;
+
         auto reseed(unsigned long seed) -> void;
     };
 
-    /** @brief First 1000 prime numbers for base selection in sequence generators. */
-    static constexpr size_t PRIME_TABLE[] = {
+    /**
+     * @brief Map points of the unit hypercube onto S^m
+     *
+     * Applies the same transformation as `Sphere3` (m == 3) or `SphereN`
+     * (m > 3) to explicit sequence values instead of the internal
+     * Van der Corput generators: `u[0]` drives the outermost level and
+     * `u[m - 1]` the innermost circle. Feeding the values
+     * `radical_inverse(k, base[i])` reproduces the k-th point of the
+     * corresponding generator. The rows are processed level by level so that
+     * each Tp table is looked up once per call.
+     *
+     * @param[in] m Number of sequence values per point (m >= 3)
+     * @param[in] u Row-major input, `count * m` values in [0, 1)
+     * @param[out] res Row-major output, `count * (m + 1)` coordinates
+     * @param[in] mode Tp inversion method
+     * @param[in] acc Accuracy policy of the sin/cos evaluations
+     *
+     * @verbatim
+     *   u = [u_0, u_1, ..., u_{m-1}]        (one row per point)
+     *         |    |          |
+     *         v    v          v
+     *        Tp   ...     Sphere/Circle  ->  [x_0, ..., x_m] on S^m
+     * @endverbatim
+     */
+    auto map_sphere_n(size_t m, span<const double> u, span<double> res,
+                      Inversion mode = Inversion::interp, Accuracy acc = Accuracy::exact)
+        -> void;
+
+    /**
+     * @brief Private copy of the interpolation tables that `map_sphere_n()` reads
+     *
+     * The Tp tables are shared process-wide and live wherever they were
+     * first built. A `TpTables` holds its own copies of the angle grid and
+     * of the tables of all levels of S^m (`Inversion::interp`); the copies
+     * are written by the constructing thread, so under the first-touch
+     * policy of the operating system they are placed on that thread's NUMA
+     * node. Threads pinned to a node can then share one replica per node.
+     */
+    class TpTables {
+        vector<double> x_grid;
+        vector<vector<double>> tables;  ///< tables[n - 2] holds the table of Tp(n)
+        size_t m;
+
+      public:
+        /**
+         * @brief Copy the tables of the levels of S^m
+         *
+         * @param[in] m Number of sequence values per point (m >= 3)
+         */
+        explicit TpTables(size_t m);
+
+        /**
+         * @brief Largest number of sequence values per point the tables serve
+         * @return size_t
+         */
+        auto dims() const -> size_t { return this->m; }
+
+        /**
+         * @brief Angles of the table entries, uniform over [0, π]
+         * @return const vector<double>&
+         */
+        auto grid() const -> const vector<double>& { return this->x_grid; }
+
+        /**
+         * @brief Table of Tp(n), 2 <= n < dims()
+         *
+         * @param[in] n Dimension parameter
+         * @return const vector<double>&
+         */
+        auto table(size_t n) const -> const vector<double>& { return this->tables[n - 2]; }
+    };
+
+    /**
+     * @brief Map points of the unit hypercube onto S^m, reading private table copies
+     *
+     * Same as `map_sphere_n()` with `Inversion::interp`, with the tables
+     * taken from `tables` instead of the shared cache.
+     *
+     * @param[in] m Number of sequence values per point (3 <= m <= tables.dims())
+     * @param[in] u Row-major input, `count * m` values in [0, 1)
+     * @param[out] res Row-major output, `count * (m + 1)` coordinates
+     * @param[in] tables Copies of the interpolation tables
+     * @param[in] acc Accuracy policy of the sin/cos evaluations
+     */
+    auto map_sphere_n(size_t m, span<const double> u, span<double> res, const TpTables& tables,
+                      Accuracy acc = Accuracy::exact) -> void;
+
+    /**
+     * @brief Transformation from sequence values to the sphere
+     */
+    enum class Mapping {
+        sphere,  ///< the mapping of `SphereN` (`Sphere3` for 3 bases, `Sphere` for 2)
+        cylind,  ///< the mapping of `CylindN`
+    };
+
+    /**
+     * @brief Map points of the unit hypercube onto S^m with the given mapping
+     *
+     * `Mapping::sphere` is `map_sphere_n()` for m >= 3. For m == 2 the
+     * mapping of `Sphere` is the cylindrical one, so it is `map_cylind_n()`,
+     * as is `Mapping::cylind` for every m. This is the one place where the
+     * batch drivers choose between the two maps.
+     *
+     * @param[in] mapping Mapping of the sequence values
+     * @param[in] m Number of sequence values per point (m >= 2)
+     * @param[in] u Row-major input, `count * m` values in [0, 1)
+     * @param[out] res Row-major output, `count * (m + 1)` coordinates
+     * @param[in] mode Tp inversion method of `Mapping::sphere`
+     * @param[in] acc Accuracy policy of the sin/cos evaluations
+     */
+    auto map_points(Mapping mapping, size_t m, span<const double> u, span<double> res,
+                    Inversion mode = Inversion::interp, Accuracy acc = Accuracy::exact) -> void;
+
+    /**
+     * @brief Instruction set a kernel variant is compiled for
+     */
+    enum class Isa {
+        generic,  ///< the baseline of the build
+        avx2,     ///< x86-64 AVX2 (without FMA, so results match `generic` bit for bit)
+    };
+
+    /** @brief Largest number of sequence values with a compile-time `map_sphere_n()` kernel */
+    constexpr size_t FIXED_MAP_MAX = 8;
+
+    /**
+     * @brief A `map_sphere_n()` kernel, as returned by `select_map_kernel()`
+     */
+    using MapKernel = void (*)(size_t m, span<const double> u, span<double> res, Inversion mode,
+                               Accuracy acc);
+
+    /**
+     * @brief Widest instruction set of the kernels that this CPU supports
+     *
+     * Detected once with `__builtin_cpu_supports()`; `Isa::generic` on
+     * compilers and targets without multi-versioned kernels.
+     *
+     * @return Isa
+     */
+    auto detect_isa() -> Isa;
+
+    /**
+     * @brief Fastest `map_sphere_n()` kernel for m sequence values
+     *
+     * For m <= FIXED_MAP_MAX the kernel is instantiated for that m, with
+     * every level unrolled; larger m share the runtime kernel. Each exists
+     * for every `Isa`. All kernels give the same points as
+     * `map_sphere_n()`, so the choice is only a matter of speed; resolve it
+     * once and call the pointer per batch.
+     *
+     * @param[in] m Number of sequence values per point (m >= 3)
+     * @param[in] isa Instruction set, at most `detect_isa()`
+     * @return MapKernel
+     */
+    auto select_map_kernel(size_t m, Isa isa) -> MapKernel;
+
+    /**
+     * @brief Map points on S^m back to the values of the unit hypercube
+     *
+     * Inverse of `map_sphere_n()`: for every unit vector, recovers the
+     * sequence values that `SphereN` (m > 3) or `Sphere3` (m == 3) would
+     * have consumed to produce it, level by level from the innermost circle.
+     * The polar angle of each level is converted with the Tp table read
+     * forwards, so no table is searched. Inputs need not be unit vectors;
+     * only their direction matters.
+     *
+     * @param[in] m Number of sequence values per point (m >= 3)
+     * @param[in] x Row-major input, `count * (m + 1)` coordinates
+     * @param[out] u Row-major output, `count * m` values in [0, 1]
+     * @param[in] mode Tp inversion method the points were generated with
+     */
+    auto inverse_sphere_n(size_t m, span<const double> x, span<double> u,
+                          Inversion mode = Inversion::interp) -> void;
+
+    /**
+     * @brief First 1000 prime numbers for base selection in sequence generators.
+     *
+     * The elements are `unsigned long`, the base type of the generators, so
+     * that a prefix of the table views as `span<const unsigned long>`.
+     */
+    static constexpr unsigned long PRIME_TABLE[] = {
         2,    3,    5,    7,    11,   13,   17,   19,   23,   29,   31,   37,   41,   43,   47,
         53,   59,   61,   67,   71,   73,   79,   83,   89,   97,   101,  103,  107,  109,  113,
         127,  131,  137,  139,  149,  151,  157,  163,  167,  173,  179,  181,  191,  193,  197,
@@ -0,0 +1,169 @@
+#pragma once
+
+/** @file stats.hpp
+ *  @brief Optional hot-path counters and trace markers.
+ *
+ *  The instrumentation is compiled in only when `SPHERE_N_STATS` is defined
+ *  (CMake option `SPHERE_N_ENABLE_STATS`). Otherwise all recording macros
+ *  expand to nothing and `stats_snapshot()` returns zeros, so callers can use
+ *  the API unconditionally.
+ */
+
+#include <array>    // for array
+#include <chrono>   // for steady_clock, nanoseconds
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+
+namespace lds2 {
+    /** @brief Generator kinds distinguished by the pop counters */
+    enum class PopKind : unsigned {
+        sphere3,   ///< Sphere3::pop()
+        sphere_n,  ///< SphereN::pop(), every nested level counts
+        cylind_n,  ///< CylindN::pop(), every nested level counts
+        halton_n,  ///< HaltonN::pop(), dim is the number of coordinates
+    };
+
+    /** @brief Number of `PopKind` values */
+    constexpr size_t POP_KINDS = 4;
+
+    /** @brief Largest sphere dimension with its own pop counter; larger ones share the last */
+    constexpr size_t STATS_MAX_DIM = 64;
+
+    /**
+     * @brief Counters collected since start-up or the last `stats_reset()`
+     *
+     * Durations are in nanoseconds of `std::chrono::steady_clock`.
+     */
+    struct StatsSnapshot {
+        bool enabled = false;  ///< whether the library was built with SPHERE_N_STATS
+        /** pops[kind][dim]: points generated on S^dim by each generator kind */
+        std::array<std::array<std::uint64_t, STATS_MAX_DIM + 1>, POP_KINDS> pops{};
+        std::uint64_t tp_builds = 0;        ///< Tp tables computed
+        std::uint64_t tp_build_ns = 0;      ///< time spent computing Tp tables
+        std::uint64_t tp_cache_hits = 0;    ///< Globals::getTp calls served from the cache
+        std::uint64_t tp_cache_misses = 0;  ///< Globals::getTp calls that built a table
+        std::uint64_t interp_calls = 0;     ///< calls to the table interpolation
+        std::uint64_t interp_ns = 0;        ///< time spent in the table interpolation
+        std::uint64_t lock_contended = 0;   ///< cacheMutex acquisitions that had to wait
+        std::uint64_t lock_wait_ns = 0;     ///< time spent waiting for cacheMutex
+
+        /**
+         * @brief Total pops of one generator kind over all dimensions
+         * @param[in] kind Generator kind
+         * @return std::uint64_t
+         */
+        auto total_pops(PopKind kind) const -> std::uint64_t {
+            std::uint64_t res = 0;
+            for (const auto c : this->pops[static_cast<size_t>(kind)]) {
+                res += c;
+            }
+            return res;
+        }
+    };
+
+    /**
+     * @brief Sum of the counters of all threads
+     * @return StatsSnapshot
+     */
+    auto stats_snapshot() -> StatsSnapshot;
+
+    /**
+     * @brief Reset all counters to zero
+     *
+     * Increments racing with the reset may be lost.
+     */
+    auto stats_reset() -> void;
+
+    /**
+     * @brief Callbacks for external trace markers (perf, ITT, ...)
+     *
+     * `begin` and `end` are called with a static string naming the region,
+     * e.g. to forward to `__itt_task_begin`/`__itt_task_end`. Either may be
+     * null.
+     */
+    struct TraceHooks {
+        void (*begin)(const char* name) = nullptr;
+        void (*end)(const char* name) = nullptr;
+    };
+
+    /**
+     * @brief Install trace marker callbacks (only effective with SPHERE_N_STATS)
+     * @param[in] hooks The callbacks; a default-constructed value removes them
+     */
+    auto set_trace_hooks(TraceHooks hooks) -> void;
+
+    namespace detail {
+        /** @brief Scalar counters, indices into the per-thread counter block */
+        enum class Counter : unsigned {
+            tp_builds,
+            tp_build_ns,
+            tp_cache_hits,
+            tp_cache_misses,
+            interp_calls,
+            interp_ns,
+            lock_contended,
+            lock_wait_ns,
+        };
+
+        auto stats_add(Counter counter, std::uint64_t value) -> void;
+        auto stats_pop(PopKind kind, size_t dim, std::uint64_t count = 1) -> void;
+        auto trace_begin(const char* name) -> void;
+        auto trace_end(const char* name) -> void;
+
+        /**
+         * @brief Adds the lifetime of the object to a duration counter
+         */
+        class ScopedTimer {
+            Counter counter;
+            std::chrono::steady_clock::time_point start;
+
+          public:
+            explicit ScopedTimer(Counter counter)
+                : counter{counter}, start{std::chrono::steady_clock::now()} {}
+            ScopedTimer(const ScopedTimer&) = delete;
+            auto operator=(const ScopedTimer&) -> ScopedTimer& = delete;
+            ~ScopedTimer() {
+                const auto elapsed = std::chrono::steady_clock::now() - this->start;
+                stats_add(this->counter,
+                          static_cast<std::uint64_t>(
+                              std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                                  .count()));
+            }
+        };
+
+        /**
+         * @brief Emits a trace marker pair around its lifetime
+         */
+        class TraceScope {
+            const char* name;
+
+          public:
+            explicit TraceScope(const char* name) : name{name} { trace_begin(name); }
+            TraceScope(const TraceScope&) = delete;
+            auto operator=(const TraceScope&) -> TraceScope& = delete;
+            ~TraceScope() { trace_end(this->name); }
+        };
+    }  // namespace detail
+}  // namespace lds2
+
+#define SPHERE_N_STATS_CAT2(a, b) a##b
+#define SPHERE_N_STATS_CAT(a, b) SPHERE_N_STATS_CAT2(a, b)
+
+#ifdef SPHERE_N_STATS
+#    define SPHERE_N_STATS_ADD(counter, value) \
+        ::lds2::detail::stats_add(::lds2::detail::Counter::counter, value)
+#    define SPHERE_N_STATS_POP(kind, dim) ::lds2::detail::stats_pop(::lds2::PopKind::kind, dim)
+#    define SPHERE_N_STATS_POPS(kind, dim, count) \
+        ::lds2::detail::stats_pop(::lds2::PopKind::kind, dim, count)
+#    define SPHERE_N_STATS_TIME(counter)                                                \
+        const ::lds2::detail::ScopedTimer SPHERE_N_STATS_CAT(stats_timer_, __LINE__)( \
+            ::lds2::detail::Counter::counter)
+#    define SPHERE_N_TRACE_SCOPE(name) \
+        const ::lds2::detail::TraceScope SPHERE_N_STATS_CAT(trace_scope_, __LINE__)(name)
+#else
+#    define SPHERE_N_STATS_ADD(counter, value) ((void)0)
+#    define SPHERE_N_STATS_POP(kind, dim) ((void)0)
+#    define SPHERE_N_STATS_POPS(kind, dim, count) ((void)0)
+#    define SPHERE_N_STATS_TIME(counter) ((void)0)
+#    define SPHERE_N_TRACE_SCOPE(name) ((void)0)
+#endif
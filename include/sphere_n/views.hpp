@@ -0,0 +1,171 @@
+#pragma once
+
+/** @file views.hpp
+ *  @brief Lazy input-range views over the sphere sequence generators.
+ */
+
+#include <cstddef>   // for size_t, ptrdiff_t
+#include <iterator>  // for input_iterator_tag, unreachable_sentinel_t
+#include <ranges>    // for view_interface
+#include <span>      // for span
+#include <utility>   // for move
+#include <vector>    // for vector
+#if __has_include(<generator>)
+#    include <generator>  // for generator
+#endif
+
+#include <sphere_n/cylind_n.hpp>  // for CylindN
+#include <sphere_n/sphere_n.hpp>  // for Sphere3, SphereN
+
+namespace lds2 {
+    /**
+     * @brief Infinite input range over the points of a generator
+     *
+     * The view owns the generator and one reusable buffer of `chunk` points.
+     * Each element is a `std::span<const double>` of `chunk * gen.size()`
+     * coordinates (row-major) that refers to the buffer and stays valid until
+     * the iterator is incremented, so a pipeline such as
+     * `sphere_n_view(base) | std::views::take(n) | std::views::transform(f)`
+     * performs no allocation per element.
+     *
+     * An element is generated when it is first dereferenced, so a range
+     * bounded by `std::views::take(n)` advances the generator by exactly n
+     * elements; an element that is stepped over without being dereferenced
+     * is still generated (and discarded) by `++`. Iteration resumes where it
+     * stopped: a later `begin()` starts at the first element not yet passed.
+     *
+     * @tparam Gen Generator type providing `size()` and `pop_into()`.
+     *
+     * @verbatim
+     *   *it -> gen.pop_into(buf) -> span<const double>(buf) -> ... -> ++it -> *it -> ...
+     * @endverbatim
+     */
+    template <typename Gen> class GeneratorView
+        : public std::ranges::view_interface<GeneratorView<Gen>> {
+        Gen gen;
+        size_t chunk;
+        vector<double> buf;
+        bool ready = false;  ///< buf holds the current element
+
+        auto fill() -> void {
+            const auto dim = this->gen.size();
+            for (auto i = 0U; i != this->chunk; ++i) {
+                this->gen.pop_into(span<double>(this->buf).subspan(i * dim, dim));
+            }
+        }
+
+      public:
+        /**
+         * @brief Input iterator yielding spans into the view's buffer
+         */
+        class iterator {
+            GeneratorView* parent = nullptr;
+
+          public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = span<const double>;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+            explicit iterator(GeneratorView* parent) : parent{parent} {}
+
+            auto operator*() const -> span<const double> {
+                if (!this->parent->ready) {
+                    this->parent->fill();
+                    this->parent->ready = true;
+                }
+                return this->parent->buf;
+            }
+
+            auto operator++() -> iterator& {
+                if (!this->parent->ready) this->parent->fill();  // passed without being read
+                this->parent->ready = false;
+                return *this;
+            }
+
+            auto operator++(int) -> void { ++*this; }
+        };
+
+        /**
+         * @brief Construct a view owning a generator
+         *
+         * @param[in] gen The generator, moved into the view
+         * @param[in] chunk Number of points per element
+         */
+        explicit GeneratorView(Gen gen, size_t chunk = 1)
+            : gen{std::move(gen)}, chunk{chunk}, buf(chunk * this->gen.size()) {}
+
+        /**
+         * @brief Iterator to the first element not yet passed
+         * @return iterator
+         */
+        auto begin() -> iterator { return iterator{this}; }
+
+        /**
+         * @brief The sequence is infinite; bound it with `std::views::take`
+         * @return std::unreachable_sentinel_t
+         */
+        auto end() const -> std::unreachable_sentinel_t { return std::unreachable_sentinel; }
+    };
+
+    /**
+     * @brief View over the points of `SphereN(base)`
+     *
+     * @param[in] base Bases of the generator
+     * @param[in] chunk Number of points per element
+     * @return GeneratorView<SphereN>
+     */
+    inline auto sphere_n_view(span<const unsigned long> base, size_t chunk = 1)
+        -> GeneratorView<SphereN> {
+        return GeneratorView<SphereN>(SphereN(base), chunk);
+    }
+
+    /**
+     * @brief View over the points of `CylindN(base)`
+     *
+     * @param[in] base Bases of the generator
+     * @param[in] chunk Number of points per element
+     * @return GeneratorView<CylindN>
+     */
+    inline auto cylind_n_view(span<const unsigned long> base, size_t chunk = 1)
+        -> GeneratorView<CylindN> {
+        return GeneratorView<CylindN>(CylindN(base), chunk);
+    }
+
+    /**
+     * @brief View over the points of `Sphere3(base)`
+     *
+     * @param[in] base Bases of the generator
+     * @param[in] chunk Number of points per element
+     * @return GeneratorView<Sphere3>
+     */
+    inline auto sphere3_view(span<const unsigned long> base, size_t chunk = 1)
+        -> GeneratorView<Sphere3> {
+        return GeneratorView<Sphere3>(Sphere3(base), chunk);
+    }
+
+#if defined(__cpp_lib_generator) && __cpp_lib_generator >= 202207L
+    /**
+     * @brief Coroutine yielding the points of a generator
+     *
+     * Each yielded span refers to a buffer owned by the coroutine frame and
+     * is overwritten by the next point.
+     *
+     * @tparam Gen Generator type providing `size()` and `pop_into()`.
+     * @param[in] gen The generator, moved into the coroutine
+     * @param[in] chunk Number of points per element
+     * @return std::generator<span<const double>>
+     */
+    template <typename Gen>
+    auto generate_points(Gen gen, size_t chunk = 1) -> std::generator<span<const double>> {
+        const auto dim = gen.size();
+        vector<double> buf(chunk * dim);
+        for (;;) {
+            for (auto i = 0U; i != chunk; ++i) {
+                gen.pop_into(span<double>(buf).subspan(i * dim, dim));
+            }
+            co_yield span<const double>(buf);
+        }
+    }
+#endif
+}  // namespace lds2
@@ -1,6 +1,15 @@
-#include <cmath>                  // for cos, sin, sqrt
+#include <algorithm>              // for clamp, min
+#include <array>                  // for array
+#include <cassert>                // for assert
+#include <cmath>                  // for atan2, cos, sin, sqrt
 #include <ldsgen/lds.hpp>         // for vdcorput, sphere
+#include <memory_resource>        // for memory_resource
+#include <numbers>                // for pi
+#include <span>                   // for span
 #include <sphere_n/cylind_n.hpp>  // for sphere_n, cylin_n, cylin_2
+#include <sphere_n/sincos.hpp>    // for sin_cos, Accuracy
+#include <sphere_n/stats.hpp>     // for SPHERE_N_STATS_POP, SPHERE_N_TRACE_SCOPE
+#include <type_traits>            // for decay_t, is_same_v
 #include <vector>                 // for vector
 
 /**
@@ -16,6 +25,30 @@ namespace lds2 {
     using std::sqrt;
     using std::vector;
 
+    /**
+     * @brief Allocator-extended copy constructor
+     *
+     * VdCorput and Circle are plain values, so copying them copies their
+     * position; only the CylindN chain needs a deep copy.
+     *
+     * @param other The generator to copy
+     * @param alloc Allocator for the nested generators
+     */
+    CylindN::CylindN(const CylindN& other, const allocator_type& alloc)
+        : n{other.n},
+          b{other.b},
+          b_circle{other.b_circle},
+          count{other.count},
+          vdc{other.vdc} {
+        auto* mr = alloc.resource();
+        std::visit(
+            [this, mr](const auto& t) {
+                using T = std::decay_t<decltype(*t)>;
+                this->c_gen = make_pmr<T>(mr, *t);  // alloc is propagated to CylindN
+            },
+            other.c_gen);
+    }
+
     /**
      * @brief Generate the next point using cylindrical coordinate method
      *
@@ -33,26 +66,54 @@ namespace lds2 {
      * 4. Transform: [sin(phi)*base_dimensions, cos(phi)]
      */
     auto CylindN::pop() -> vector<double> {
+        vector<double> res(this->size());
+        this->pop_into(res);
+        return res;
+    }
+
+    /**
+     * @brief Generate the next point into a pmr vector
+     *
+     * @param mr The memory resource for the result
+     * @return std::pmr::vector<double> An (n+1)-dimensional point [x1, x2, ..., xn, z]
+     */
+    auto CylindN::pop(std::pmr::memory_resource* mr) -> std::pmr::vector<double> {
+        std::pmr::vector<double> res(this->size(), mr);
+        this->pop_into(res);
+        return res;
+    }
+
+    /**
+     * @brief Generate the next point into a buffer
+     *
+     * The base dimensions are generated in place in the leading
+     * `size() - 1` entries of `res` and then scaled by sin(phi).
+     *
+     * @param res Output buffer of size `size()`
+     */
+    auto CylindN::pop_into(span<double> res) -> void {
+        assert(res.size() == this->size());
+        SPHERE_N_STATS_POP(cylind_n, this->n);
+        ++this->count;
         const auto cosphi = 2.0 * this->vdc.pop() - 1.0;  // map to [-1, 1];
         const auto sinphi = sqrt(1.0 - cosphi * cosphi);
-        auto res = std::visit(
-            [](auto& t) {
+        const auto head = res.first(res.size() - 1);
+        std::visit(
+            [head](auto& t) {
                 using T = std::decay_t<decltype(*t)>;
                 if constexpr (std::is_same_v<T, Circle>) {
-                    auto arr = t->pop();
-                    return vector<double>(arr.begin(), arr.end());
-                } else if constexpr (std::is_same_v<T, CylindN>) {
-                    return t->pop();
+                    const auto [c0, c1] = t->pop();
+                    head[0] = c0;
+                    head[1] = c1;
                 } else {
-                    return vector<double>{};
+                    t->pop_into(head);
                 }
             },
             this->c_gen);
-        for (auto& xi : res) {
+        for (auto& xi : head) {
             xi *= sinphi;
         }
-        res.emplace_back(cosphi);
-        return res;
+        res.back() = cosphi;
     }
 
     /**
@@ -65,8 +126,127 @@ namespace lds2 {
      * @param seed The seed value to reset to
      */
     auto CylindN::reseed(unsigned long seed) -> void {
+        this->count = seed;
         this->vdc.reseed(seed);
         std::visit([seed](auto& t) { t->reseed(seed); }, this->c_gen);
     }
 
+    /**
+     * @brief Append the bases of this level and all nested levels
+     *
+     * @param res Output list of bases, outermost first
+     */
+    auto CylindN::collect_bases(vector<unsigned long>& res) const -> void {
+        res.push_back(this->b);
+        std::visit(
+            [this, &res](const auto& t) {
+                using T = std::decay_t<decltype(*t)>;
+                if constexpr (std::is_same_v<T, Circle>) {
+                    res.push_back(this->b_circle);
+                } else {
+                    t->collect_bases(res);
+                }
+            },
+            this->c_gen);
+    }
+
+    /**
+     * @brief Snapshot of the bases and the current position
+     *
+     * @return GenState
+     */
+    auto CylindN::state() const -> GenState {
+        GenState res;
+        res.base.reserve(this->n);
+        this->collect_bases(res.base);
+        res.index = this->count;
+        return res;
+    }
+
+    /**
+     * @brief Map points of the unit hypercube onto S^m with the cylindrical method
+     *
+     * The circle angles of a block of rows are evaluated in one `sin_cos()`
+     * call. sin(phi) = sqrt(1 - cos(phi)^2) needs no policy: it is a single
+     * hardware instruction.
+     *
+     * @param m Number of sequence values per point
+     * @param u Row-major input values
+     * @param res Row-major output coordinates
+     * @param acc Accuracy policy of the circle's sin/cos evaluations
+     */
+    auto map_cylind_n(size_t m, span<const double> u, span<double> res, Accuracy acc) -> void {
+        assert(m >= 2);
+        SPHERE_N_TRACE_SCOPE("lds2::map_cylind_n");
+        const auto count = u.size() / m;
+        assert(u.size() == count * m && res.size() == count * (m + 1));
+        const auto stride = m + 1;
+        constexpr size_t MAP_BLOCK = 64;
+        array<double, MAP_BLOCK> theta;
+        array<double, MAP_BLOCK> sint;
+        array<double, MAP_BLOCK> cost;
+        for (auto r0 = size_t{0}; r0 < count; r0 += MAP_BLOCK) {
+            const auto nb = std::min(MAP_BLOCK, count - r0);
+            for (auto r = 0U; r != nb; ++r) {
+                theta[r] = 2.0 * std::numbers::pi * u[(r0 + r) * m + m - 1];
+            }
+            sin_cos(acc, span<const double>(theta).first(nb), span<double>(sint).first(nb),
+                    span<double>(cost).first(nb));
+            for (auto r = 0U; r != nb; ++r) {
+                const auto* ur = &u[(r0 + r) * m];
+                auto* xr = &res[(r0 + r) * stride];
+                xr[0] = cost[r];
+                xr[1] = sint[r];
+                for (auto len = size_t{2}; len != stride; ++len) {
+                    const auto cosphi = 2.0 * ur[m - len] - 1.0;  // map to [-1, 1];
+                    const auto sinphi = sqrt(1.0 - cosphi * cosphi);
+                    for (auto j = 0U; j != len; ++j) {
+                        xr[j] *= sinphi;
+                    }
+                    xr[len] = cosphi;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Map points on S^m back to the values of the unit hypercube
+     *
+     * The squared norms of the prefixes x[0..len] are accumulated across a
+     * block of rows, innermost level first, so every level is one pass over
+     * the block with a single square root per value.
+     *
+     * @param m Number of sequence values per point
+     * @param x Row-major input coordinates
+     * @param u Row-major output values
+     */
+    auto inverse_cylind_n(size_t m, span<const double> x, span<double> u) -> void {
+        assert(m >= 2);
+        SPHERE_N_TRACE_SCOPE("lds2::inverse_cylind_n");
+        const auto stride = m + 1;
+        const auto count = x.size() / stride;
+        assert(x.size() == count * stride && u.size() == count * m);
+        constexpr size_t MAP_BLOCK = 64;
+        array<double, MAP_BLOCK> norm2;
+        for (auto r0 = size_t{0}; r0 < count; r0 += MAP_BLOCK) {
+            const auto nb = std::min(MAP_BLOCK, count - r0);
+            for (auto r = 0U; r != nb; ++r) {
+                const auto* xr = &x[(r0 + r) * stride];
+                auto theta = std::atan2(xr[1], xr[0]) / (2.0 * std::numbers::pi);
+                theta += (theta < 0.0) ? 1.0 : 0.0;
+                u[(r0 + r) * m + m - 1] = (theta < 1.0) ? theta : 0.0;
+                norm2[r] = xr[0] * xr[0] + xr[1] * xr[1];
+            }
+            for (auto len = size_t{2}; len != stride; ++len) {
+                for (auto r = 0U; r != nb; ++r) {
+                    const auto c = x[(r0 + r) * stride + len];
+                    norm2[r] += c * c;
+                    const auto len_r = sqrt(norm2[r]);
+                    const auto cosphi = (len_r > 0.0) ? c / len_r : 0.0;
+                    u[(r0 + r) * m + m - len] = std::clamp(0.5 * (cosphi + 1.0), 0.0, 1.0);
+                }
+            }
+        }
+    }
+
 }  // namespace lds2
@@ -0,0 +1,123 @@
+#include <algorithm>              // for min
+#include <cstddef>                // for size_t
+#include <iterator>               // for size
+#include <memory>                 // for make_unique, unique_ptr
+#include <span>                   // for span
+#include <sphere_n/factory.hpp>   // for make_generator, Generator, GeneratorKind
+#include <sphere_n/halton_n.hpp>  // for HaltonN
+#include <sphere_n/sphere_n.hpp>  // for select_map_kernel, detect_isa, map_points, PRIME_TABLE
+#include <stdexcept>              // for invalid_argument
+#include <string>                 // for string, to_string
+#include <utility>                // for move
+#include <vector>                 // for vector
+
+using std::span;
+using std::vector;
+
+/** @brief Points whose sequence values are generated and mapped together */
+static constexpr size_t FACTORY_BLOCK = 256;
+
+/**
+ * @brief `map_points()` with `Mapping::cylind` in the signature of a `MapKernel`
+ *
+ * @param m Number of sequence values per point
+ * @param u Row-major input values
+ * @param res Row-major output coordinates
+ * @param mode Tp inversion method, unused by the cylindrical map
+ * @param acc Accuracy policy
+ */
+static auto map_cylind(size_t m, span<const double> u, span<double> res, lds2::Inversion mode,
+                       lds2::Accuracy acc) -> void {
+    lds2::map_points(lds2::Mapping::cylind, m, u, res, mode, acc);
+}
+
+/**
+ * @brief Kernel of the sphere and cylinder kinds: Halton batches and a map kernel
+ */
+class MappedKernel final : public lds2::Generator::Kernel {
+    lds2::HaltonN halton;
+    lds2::MapKernel map;
+    lds2::Inversion mode;
+    lds2::Accuracy acc;
+    vector<double> u;
+
+  public:
+    MappedKernel(size_t m, lds2::MapKernel map, const lds2::GeneratorOptions& opts)
+        : halton(m), map{map}, mode{opts.inversion}, acc{opts.accuracy}, u(FACTORY_BLOCK * m) {
+        this->halton.reseed(opts.seed);
+    }
+
+    auto pop_batch(span<double> res) -> void override {
+        const auto m = this->halton.size();
+        const auto dim = m + 1;
+        const auto count = res.size() / dim;
+        for (auto k = size_t{0}; k < count; k += FACTORY_BLOCK) {
+            const auto len = std::min(FACTORY_BLOCK, count - k);
+            const auto ub = span<double>(this->u).first(len * m);
+            this->halton.pop_batch(ub);
+            this->map(m, ub, res.subspan(k * dim, len * dim), this->mode, this->acc);
+        }
+    }
+
+    auto reseed(unsigned long seed) -> void override { this->halton.reseed(seed); }
+    auto skip(unsigned long n) -> void override { this->halton.skip(n); }
+
+    auto clone() const -> std::unique_ptr<lds2::Generator::Kernel> override {
+        return std::make_unique<MappedKernel>(*this);
+    }
+};
+
+/**
+ * @brief Kernel of the halton kind
+ */
+class HaltonKernel final : public lds2::Generator::Kernel {
+    lds2::HaltonN halton;
+
+  public:
+    HaltonKernel(size_t dim, unsigned long seed) : halton(dim) { this->halton.reseed(seed); }
+
+    auto pop_batch(span<double> res) -> void override { this->halton.pop_batch(res); }
+    auto reseed(unsigned long seed) -> void override { this->halton.reseed(seed); }
+    auto skip(unsigned long n) -> void override { this->halton.skip(n); }
+
+    auto clone() const -> std::unique_ptr<lds2::Generator::Kernel> override {
+        return std::make_unique<HaltonKernel>(*this);
+    }
+};
+
+namespace lds2 {
+    /**
+     * @brief Generator of the given kind with `dim` coordinates per point
+     *
+     * @param kind Sequence to generate
+     * @param dim Coordinates per point
+     * @param opts Options
+     * @return Generator
+     */
+    auto make_generator(GeneratorKind kind, size_t dim, const GeneratorOptions& opts)
+        -> Generator {
+        const auto n_primes = std::size(PRIME_TABLE);
+        if (kind == GeneratorKind::halton) {
+            if (dim == 0 || dim > n_primes) {
+                throw std::invalid_argument("make_generator: halton needs 1 to "
+                                            + std::to_string(n_primes) + " coordinates");
+            }
+            return Generator(std::make_unique<HaltonKernel>(dim, opts.seed), dim, "halton/flat");
+        }
+        if (dim < 3 || dim > n_primes + 1) {
+            throw std::invalid_argument("make_generator: spheres need 3 to "
+                                        + std::to_string(n_primes + 1) + " coordinates");
+        }
+        const auto m = dim - 1;
+        if (kind == GeneratorKind::cylind || m == 2) {
+            const auto name = (kind == GeneratorKind::cylind) ? "cylind/flat" : "sphere/cylind";
+            return Generator(std::make_unique<MappedKernel>(m, &map_cylind, opts), dim, name);
+        }
+        const auto isa = opts.simd ? detect_isa() : Isa::generic;
+        auto name = std::string("sphere/");
+        name += (m <= FIXED_MAP_MAX) ? "fixed<" + std::to_string(m) + ">" : std::string("flat");
+        name += (isa == Isa::avx2) ? "/avx2" : "/generic";
+        return Generator(std::make_unique<MappedKernel>(m, select_map_kernel(m, isa), opts), dim,
+                         std::move(name));
+    }
+}  // namespace lds2
@@ -0,0 +1,143 @@
+#include <algorithm>               // for any_of
+#include <array>                   // for array
+#include <cstddef>                 // for size_t
+#include <cstdint>                 // for uint64_t, uint8_t
+#include <istream>                 // for istream
+#include <ostream>                 // for ostream
+#include <span>                    // for span
+#include <sphere_n/gen_state.hpp>  // for GenState
+#include <sphere_n/rotation.hpp>   // for Antipodal
+#include <sphere_n/sincos.hpp>     // for Accuracy
+#include <sphere_n/sphere_n.hpp>   // for Inversion
+#include <stdexcept>               // for runtime_error, invalid_argument
+#include <string>                  // for string
+
+/** @brief Tag at the start of every serialized state */
+static constexpr std::array<char, 4> STATE_MAGIC = {'L', 'D', 'S', '2'};
+
+/** @brief Format written by `write_state()` */
+static constexpr std::uint64_t STATE_VERSION = 1;
+
+/** @brief Upper bound on the number of bases accepted when reading a state */
+static constexpr std::uint64_t MAX_STATE_BASES = 1U << 16U;
+
+/**
+ * @brief Write a 64-bit integer in little-endian byte order
+ *
+ * @param os Output stream
+ * @param value The value to write
+ */
+static void put_u64(std::ostream& os, std::uint64_t value) {
+    std::array<char, 8> bytes{};
+    for (auto& byte : bytes) {
+        byte = static_cast<char>(value & 0xFFU);
+        value >>= 8U;
+    }
+    os.write(bytes.data(), bytes.size());
+}
+
+/**
+ * @brief Read a 64-bit integer in little-endian byte order
+ *
+ * @param is Input stream
+ * @return std::uint64_t The value read
+ */
+static auto get_u64(std::istream& is) -> std::uint64_t {
+    std::array<char, 8> bytes{};
+    if (!is.read(bytes.data(), bytes.size())) {
+        throw std::runtime_error("lds2::read_state: truncated state");
+    }
+    std::uint64_t value = 0;
+    for (auto it = bytes.rbegin(); it != bytes.rend(); ++it) {
+        value = (value << 8U) | static_cast<std::uint8_t>(*it);
+    }
+    return value;
+}
+
+namespace lds2 {
+    /**
+     * @brief Bases of a state about to be restored, after checking them
+     *
+     * @param state The state
+     * @param who Name of the generator, for the message
+     * @param min_bases Fewest bases the generator accepts
+     * @param max_bases Most bases the generator accepts
+     * @return std::span<const unsigned long> `state.base`
+     */
+    auto checked_bases(const GenState& state, const char* who, size_t min_bases, size_t max_bases)
+        -> std::span<const unsigned long> {
+        const auto m = state.base.size();
+        if (m < min_bases || m > max_bases) {
+            throw std::invalid_argument(std::string(who) + ": wrong number of bases in state");
+        }
+        if (std::any_of(state.base.begin(), state.base.end(), [](auto b) { return b < 2; })) {
+            throw std::invalid_argument(std::string(who) + ": base below 2 in state");
+        }
+        return state.base;
+    }
+
+    /**
+     * @brief Write a generator state in a portable binary format
+     *
+     * @param os Output stream
+     * @param state The state to write
+     */
+    auto write_state(std::ostream& os, const GenState& state) -> void {
+        os.write(STATE_MAGIC.data(), STATE_MAGIC.size());
+        put_u64(os, STATE_VERSION);
+        put_u64(os, static_cast<std::uint64_t>(state.inversion)
+                        | (static_cast<std::uint64_t>(state.accuracy) << 8U)
+                        | (static_cast<std::uint64_t>(state.antipodal) << 16U));
+        put_u64(os, state.base.size());
+        for (const auto b : state.base) {
+            put_u64(os, b);
+        }
+        put_u64(os, state.index);
+    }
+
+    /**
+     * @brief Read a generator state written by `write_state()`
+     *
+     * @param is Input stream
+     * @return GenState The restored state
+     */
+    auto read_state(std::istream& is) -> GenState {
+        std::array<char, 4> magic{};
+        if (!is.read(magic.data(), magic.size()) || magic != STATE_MAGIC) {
+            throw std::runtime_error("lds2::read_state: not a generator state");
+        }
+        if (get_u64(is) != STATE_VERSION) {
+            throw std::runtime_error("lds2::read_state: unknown format version");
+        }
+        GenState state;
+        const auto modes = get_u64(is);
+        if ((modes >> 24U) != 0) {
+            throw std::runtime_error("lds2::read_state: unknown modes");
+        }
+        const auto inversion = modes & 0xFFU;
+        if (inversion > static_cast<std::uint64_t>(Inversion::newton)) {
+            throw std::runtime_error("lds2::read_state: unknown inversion method");
+        }
+        const auto accuracy = (modes >> 8U) & 0xFFU;
+        if (accuracy > static_cast<std::uint64_t>(Accuracy::fast)) {
+            throw std::runtime_error("lds2::read_state: unknown accuracy policy");
+        }
+        const auto antipodal = (modes >> 16U) & 0xFFU;
+        if (antipodal > static_cast<std::uint64_t>(Antipodal::fold)) {
+            throw std::runtime_error("lds2::read_state: unknown antipodal method");
+        }
+        state.inversion = static_cast<Inversion>(inversion);
+        state.accuracy = static_cast<Accuracy>(accuracy);
+        state.antipodal = static_cast<Antipodal>(antipodal);
+        const auto m = get_u64(is);
+        if (m > MAX_STATE_BASES) {
+            throw std::runtime_error("lds2::read_state: too many bases");
+        }
+        state.base.resize(static_cast<size_t>(m));
+        for (auto& b : state.base) {
+            b = static_cast<unsigned long>(get_u64(is));
+        }
+        state.index = static_cast<unsigned long>(get_u64(is));
+        return state;
+    }
+}  // namespace lds2
@@ -0,0 +1,198 @@
+#include <algorithm>              // for copy_n, max, min
+#include <cassert>                // for assert
+#include <cstddef>                // for size_t
+#include <iterator>               // for size
+#include <span>                   // for span
+#include <sphere_n/halton_n.hpp>  // for HaltonN
+#include <sphere_n/sphere_n.hpp>  // for PRIME_TABLE
+#include <sphere_n/stats.hpp>     // for SPHERE_N_STATS_POP, SPHERE_N_STATS_POPS
+#include <stdexcept>              // for invalid_argument
+#include <string>                 // for to_string
+#include <vector>                 // for vector
+
+/** @brief Number of independent radical inverses evaluated together */
+static constexpr size_t LANES = 8;
+
+/**
+ * @brief Radical inverses of LANES (index, base) pairs
+ *
+ * Performs the same operations as `lds2::radical_inverse()` in every lane,
+ * with the quotient floor(k / b) computed in double precision. Since the
+ * fractional part of k / b is 0 or at least 1/b, rounding
+ * k / b - (1/2 - 1/(2b)) to the nearest integer gives the floor exactly
+ * for k < 2^51, without a comparison. All lanes run for the digit count
+ * of the largest index in the smallest base (finished lanes add zero
+ * digits), so the lane loop has a fixed trip count and no branches, and
+ * vectorizes.
+ *
+ * @param k Indices, as doubles
+ * @param b Bases, as doubles
+ * @param res Output radical inverses
+ */
+static void radical_inverse_lanes(const double* k, const double* b, double* res) {
+    constexpr double ROUND = 0x1.8p52;  // adding and subtracting it rounds to an integer
+    double kd[LANES];
+    double bd[LANES];
+    double off[LANES];
+    double den[LANES];
+    double acc[LANES];
+    auto kmax = 0.0;
+    auto bmin = b[0];
+    for (auto l = 0U; l != LANES; ++l) {
+        kd[l] = k[l];
+        bd[l] = b[l];
+        off[l] = 0.5 - 0.5 / b[l];
+        den[l] = 1.0;
+        acc[l] = 0.0;
+        kmax = std::max(kmax, k[l]);
+        bmin = std::min(bmin, b[l]);
+    }
+    auto n_digits = 0U;
+    for (auto v = static_cast<unsigned long>(kmax); v != 0; v /= static_cast<unsigned long>(bmin)) {
+        ++n_digits;
+    }
+    for (auto j = 0U; j != n_digits; ++j) {
+        for (auto l = 0U; l != LANES; ++l) {
+            const auto q = ((kd[l] / bd[l] - off[l]) + ROUND) - ROUND;
+            den[l] *= bd[l];
+            acc[l] += (kd[l] - q * bd[l]) / den[l];
+            kd[l] = q;
+        }
+    }
+    for (auto l = 0U; l != LANES; ++l) {
+        res[l] = acc[l];
+    }
+}
+
+/**
+ * @brief The first `dim` primes of PRIME_TABLE
+ *
+ * @param dim Number of primes
+ * @return std::span<const unsigned long>
+ */
+static auto first_primes(size_t dim) -> std::span<const unsigned long> {
+    const auto n_primes = std::size(lds2::PRIME_TABLE);
+    if (dim == 0 || dim > n_primes) {
+        throw std::invalid_argument("HaltonN: between 1 and " + std::to_string(n_primes)
+                                    + " coordinates");
+    }
+    return {lds2::PRIME_TABLE, dim};
+}
+
+namespace lds2 {
+    /**
+     * @brief Construct a new HaltonN object
+     *
+     * @param base Bases of the coordinates
+     */
+    HaltonN::HaltonN(span<const unsigned long> base)
+        : base(base.begin(), base.end()), fbase(base.begin(), base.end()) {
+        if (base.empty()) {
+            throw std::invalid_argument("HaltonN: at least 1 coordinate");
+        }
+        for ([[maybe_unused]] const auto b : base) {
+            assert(b >= 2);
+        }
+        // pad to whole lane blocks; the padding lanes are computed and discarded
+        this->fbase.resize((base.size() + LANES - 1) / LANES * LANES, 2.0);
+    }
+
+    /**
+     * @brief Construct a HaltonN object on the first `dim` primes of PRIME_TABLE
+     *
+     * @param dim Number of coordinates
+     */
+    HaltonN::HaltonN(size_t dim) : HaltonN(first_primes(dim)) {}
+
+    /**
+     * @brief Generate the next point into a buffer
+     *
+     * @param res Output buffer of size `size()`
+     */
+    auto HaltonN::pop_into(span<double> res) -> void {
+        SPHERE_N_STATS_POP(halton_n, this->size());
+        this->point(++this->count, res);
+    }
+
+    /**
+     * @brief The point with index k, vectorized across dimensions
+     *
+     * @param k Index into the sequence
+     * @param res Output buffer of size `size()`
+     */
+    auto HaltonN::point(unsigned long k, span<double> res) const -> void {
+        assert(res.size() == this->size());
+        const auto dim = this->size();
+        double kd[LANES];
+        double out[LANES];
+        for (auto& v : kd) {
+            v = static_cast<double>(k);
+        }
+        for (auto d = size_t{0}; d < dim; d += LANES) {
+            radical_inverse_lanes(kd, &this->fbase[d], out);
+            std::copy_n(out, std::min(LANES, dim - d), &res[d]);
+        }
+    }
+
+    /**
+     * @brief Generate the next n_pts points, LANES consecutive points at a time
+     *
+     * @tparam Store Callable `store(d, i, value)` receiving coordinate d of point i
+     * @param n_pts Number of points
+     * @param store Output callback
+     */
+    template <typename Store> auto HaltonN::pop_blocks(size_t n_pts, Store&& store) -> void {
+        const auto dim = this->size();
+        SPHERE_N_STATS_POPS(halton_n, dim, n_pts);
+        double kd[LANES];
+        double bd[LANES];
+        double out[LANES];
+        for (auto i0 = size_t{0}; i0 < n_pts; i0 += LANES) {
+            const auto nl = std::min(LANES, n_pts - i0);
+            for (auto l = 0U; l != LANES; ++l) {
+                kd[l] = static_cast<double>(this->count + 1 + i0 + l);
+            }
+            for (auto d = size_t{0}; d != dim; ++d) {
+                for (auto& v : bd) {
+                    v = this->fbase[d];
+                }
+                radical_inverse_lanes(kd, bd, out);
+                for (auto l = 0U; l != nl; ++l) {
+                    store(d, i0 + l, out[l]);
+                }
+            }
+        }
+        this->count += n_pts;
+    }
+
+    /**
+     * @brief Generate the next points, row-major
+     *
+     * Same lane layout as `pop_soa()` (one base per block of consecutive
+     * points, so no lane waits for the digits of a smaller base), with a
+     * strided store.
+     *
+     * @param res Output buffer, a multiple of `size()` values
+     */
+    auto HaltonN::pop_batch(span<double> res) -> void {
+        const auto dim = this->size();
+        assert(res.size() % dim == 0);
+        this->pop_blocks(res.size() / dim, [res, dim](size_t d, size_t i, double value) {
+            res[i * dim + d] = value;
+        });
+    }
+
+    /**
+     * @brief Generate the next points, coordinate-major
+     *
+     * @param res Output buffer, a multiple of `size()` values
+     */
+    auto HaltonN::pop_soa(span<double> res) -> void {
+        const auto dim = this->size();
+        assert(res.size() % dim == 0);
+        const auto n_pts = res.size() / dim;
+        this->pop_blocks(n_pts, [res, n_pts](size_t d, size_t i, double value) {
+            res[d * n_pts + i] = value;
+        });
+    }
+}  // namespace lds2
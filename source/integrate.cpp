@@ -0,0 +1,97 @@
+#include <algorithm>               // for max, min
+#include <cassert>                 // for assert
+#include <cmath>                   // for abs, sqrt
+#include <cstddef>                 // for size_t
+#include <limits>                  // for numeric_limits
+#include <span>                    // for span
+#include <sphere_n/halton_n.hpp>   // for HaltonN
+#include <sphere_n/integrate.hpp>  // for integrate_blocks, IntegrateOptions, Estimate
+#include <sphere_n/sphere_n.hpp>   // for map_points
+#include <sphere_n/stats.hpp>      // for SPHERE_N_TRACE_SCOPE
+#include <vector>                  // for vector
+
+#include "parallel.hpp"  // for parallel_tasks
+
+using std::span;
+using std::vector;
+
+/**
+ * @brief Generator and block buffers owned by one worker for a whole round
+ */
+struct BlockWorker {
+    lds2::HaltonN halton;
+    vector<double> u;  ///< sequence values of a block
+    vector<double> x;  ///< points of a block
+};
+
+namespace lds2 {
+    /**
+     * @brief Block-level driver behind `integrate()`
+     *
+     * Every worker owns a `HaltonN` and two block buffers for the whole
+     * round; a block is generated by `reseed()` to its first index and one
+     * `pop_batch()`, then mapped and passed to `block_fn`. The block sums of
+     * a round are stored by block index and folded into the total in that
+     * order once all workers have joined. The first exception thrown by a
+     * worker (e.g. by `block_fn`) stops the claiming of blocks and is
+     * rethrown once all workers have joined.
+     *
+     * @param base Bases of the sequence values
+     * @param n Largest number of points
+     * @param opts Options
+     * @param block_fn Evaluates a block of points
+     * @param progress Receives every running estimate
+     * @return Estimate
+     */
+    auto integrate_blocks(span<const unsigned long> base, size_t n, const IntegrateOptions& opts,
+                          const BlockFn& block_fn, const ProgressFn& progress) -> Estimate {
+        SPHERE_N_TRACE_SCOPE("lds2::integrate");
+        const auto m = base.size();
+        assert(m >= 2 && opts.block_points > 0);
+        const auto block = opts.block_points;
+        const auto n_blocks = (n + block - 1) / block;
+        const auto round_points = (opts.report_every == 0) ? n : opts.report_every;
+        const auto round_blocks = std::max((round_points + block - 1) / block, size_t{1});
+
+        vector<BlockSums> sums(round_blocks);
+        BlockSums total;
+        auto est = Estimate{};
+        est.change = std::numeric_limits<double>::infinity();
+        for (auto b0 = size_t{0}; b0 < n_blocks; b0 += round_blocks) {
+            const auto nb = std::min(round_blocks, n_blocks - b0);
+            const auto init = [&] {
+                return BlockWorker{HaltonN(base), vector<double>(block * m),
+                                   vector<double>(block * (m + 1))};
+            };
+            detail::parallel_tasks(opts.threads, nb, init, [&](BlockWorker& w, size_t i) {
+                const auto first = (b0 + i) * block;
+                const auto count = std::min(block, n - first);
+                const auto ub = span<double>(w.u).first(count * m);
+                const auto xb = span<double>(w.x).first(count * (m + 1));
+                w.halton.reseed(first);
+                w.halton.pop_batch(ub);
+                map_points(opts.mapping, m, ub, xb, opts.inversion);
+                sums[i] = BlockSums{};
+                block_fn(xb, sums[i]);
+            });
+
+            for (auto i = size_t{0}; i != nb; ++i) {
+                total.f.merge(sums[i].f);
+                total.f2.merge(sums[i].f2);
+            }
+            const auto done = std::min(n, (b0 + nb) * block);
+            const auto nd = static_cast<double>(done);
+            const auto mean = total.f.value() / nd;
+            const auto var = std::max(total.f2.value() / nd - mean * mean, 0.0);
+            est.change = (est.n_points == 0) ? est.change : std::abs(mean - est.mean);
+            est.n_points = done;
+            est.mean = mean;
+            est.std_error = std::sqrt(var / nd);
+            const auto tol = std::max(opts.abs_tol, opts.rel_tol * std::abs(mean));
+            est.converged = tol > 0.0 && est.change <= tol;
+            if (progress && !progress(est)) break;
+            if (est.converged) break;
+        }
+        return est;
+    }
+}  // namespace lds2
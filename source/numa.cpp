@@ -0,0 +1,310 @@
+#include <algorithm>               // for binary_search, fill, max, min, stable_sort
+#include <cassert>                 // for assert
+#include <charconv>                // for from_chars
+#include <cstddef>                 // for size_t
+#include <exception>               // for exception_ptr, current_exception, rethrow_exception
+#include <fstream>                 // for ifstream
+#include <memory>                  // for make_unique_for_overwrite
+#include <mutex>                   // for once_flag, call_once, mutex, lock_guard
+#include <optional>                // for optional
+#include <span>                    // for span
+#include <sphere_n/halton_n.hpp>   // for HaltonN
+#include <sphere_n/numa.hpp>       // for generate_bulk, BulkPoints, NumaNode
+#include <sphere_n/sphere_n.hpp>   // for map_points, map_sphere_n, TpTables
+#include <sphere_n/stats.hpp>      // for SPHERE_N_TRACE_SCOPE
+#include <string>                  // for string, to_string, getline
+#include <string_view>             // for string_view
+#include <system_error>            // for errc, system_error
+#include <thread>                  // for thread
+#include <utility>                 // for move
+#include <vector>                  // for vector
+
+#if defined(__linux__) && __has_include(<sched.h>)
+#    define SPHERE_N_HAS_AFFINITY 1
+#    include <sched.h>  // for sched_getaffinity, sched_setaffinity, CPU_SET
+#else
+#    define SPHERE_N_HAS_AFFINITY 0
+#endif
+
+#include "parallel.hpp"  // for parallel_tasks
+
+using std::span;
+using std::vector;
+
+/** @brief Points generated and mapped per batch of a worker */
+static constexpr size_t BULK_BLOCK = 256;
+
+/**
+ * @brief CPUs the calling thread may run on, ascending
+ *
+ * @return vector<int>
+ */
+static auto usable_cpus() -> vector<int> {
+    vector<int> cpus;
+#if SPHERE_N_HAS_AFFINITY
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (auto cpu = 0; cpu != CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        const auto n = std::max(1U, std::thread::hardware_concurrency());
+        for (auto cpu = 0U; cpu != n; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+/**
+ * @brief Pin the calling thread to one CPU; a no-op where affinity is unsupported
+ *
+ * @param cpu The CPU
+ */
+static auto pin_to_cpu(int cpu) -> void {
+#if SPHERE_N_HAS_AFFINITY
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);  // best effort: an unpinned worker is still correct
+#else
+    (void)cpu;
+#endif
+}
+
+/**
+ * @brief A worker of `generate_bulk()`: its node, its CPU and its slice of the points
+ */
+struct BulkWorker {
+    size_t node;   ///< index into the topology
+    int cpu;       ///< CPU the worker is pinned to
+    size_t first;  ///< index of the first point of its slice
+    size_t count;  ///< points in its slice
+};
+
+/**
+ * @brief Generator and block buffer owned by one worker of `generate_bulk()`
+ */
+struct BulkBuffers {
+    lds2::HaltonN halton;
+    vector<double> u;  ///< sequence values of a block
+};
+
+/**
+ * @brief Spread the workers over the nodes in proportion to their CPUs
+ *
+ * Worker t takes CPU t (modulo the number of CPUs) of the CPUs of all
+ * nodes in node order; the workers are then grouped by node, and the
+ * slices are handed out in that order, so each node writes one
+ * contiguous range.
+ *
+ * @param nodes The topology
+ * @param threads Requested workers, 0 for one per CPU
+ * @param n Number of points
+ * @return vector<BulkWorker>
+ */
+static auto plan_workers(span<const lds2::NumaNode> nodes, size_t threads, size_t n)
+    -> vector<BulkWorker> {
+    vector<BulkWorker> slots;
+    for (auto i = size_t{0}; i != nodes.size(); ++i) {
+        for (const auto cpu : nodes[i].cpus) {
+            slots.push_back(BulkWorker{i, cpu, 0, 0});
+        }
+    }
+    if (threads == 0) threads = slots.size();
+    threads = std::max(size_t{1}, std::min(threads, std::max(n, size_t{1})));
+
+    vector<BulkWorker> workers;
+    for (auto t = size_t{0}; t != threads; ++t) {
+        workers.push_back(slots[t % slots.size()]);
+    }
+    std::stable_sort(workers.begin(), workers.end(),
+                     [](const BulkWorker& a, const BulkWorker& b) { return a.node < b.node; });
+    for (auto t = size_t{0}; t != threads; ++t) {
+        workers[t].first = n * t / threads;
+        workers[t].count = n * (t + 1) / threads - workers[t].first;
+    }
+    return workers;
+}
+
+/**
+ * @brief Map one batch of sequence values onto S^m
+ *
+ * @param m Number of sequence values per point
+ * @param u Row-major input values
+ * @param x Row-major output coordinates
+ * @param opts Options
+ * @param tables Table replica of the worker's node, or nullptr for the shared tables
+ */
+static auto map_batch(size_t m, span<const double> u, span<double> x,
+                      const lds2::BulkOptions& opts, const lds2::TpTables* tables) -> void {
+    if (tables != nullptr) {
+        lds2::map_sphere_n(m, u, x, *tables, opts.accuracy);
+    } else {
+        lds2::map_points(lds2::Mapping::sphere, m, u, x, opts.inversion, opts.accuracy);
+    }
+}
+
+namespace lds2 {
+    /**
+     * @brief Parse a CPU list such as "0-3,8-11,16"
+     *
+     * @param list CPU list
+     * @return vector<int>
+     */
+    auto parse_cpu_list(std::string_view list) -> vector<int> {
+        vector<int> cpus;
+        while (!list.empty() && (list.back() == '\n' || list.back() == ' ')) {
+            list.remove_suffix(1);
+        }
+        const auto* pos = list.data();
+        const auto* const end = list.data() + list.size();
+        while (pos != end) {
+            auto lo = 0;
+            auto [next, ec] = std::from_chars(pos, end, lo);
+            if (ec != std::errc{}) return {};
+            auto hi = lo;
+            if (next != end && *next == '-') {
+                const auto [after, ec_hi] = std::from_chars(next + 1, end, hi);
+                if (ec_hi != std::errc{} || hi < lo) return {};
+                next = after;
+            }
+            for (auto cpu = lo; cpu <= hi; ++cpu) {
+                cpus.push_back(cpu);
+            }
+            if (next != end && *next != ',') return {};
+            pos = (next == end) ? end : next + 1;
+        }
+        return cpus;
+    }
+
+    /**
+     * @brief NUMA nodes with at least one usable CPU
+     *
+     * @return vector<NumaNode>
+     */
+    auto numa_topology() -> vector<NumaNode> {
+        const auto usable = usable_cpus();
+        vector<NumaNode> nodes;
+#if SPHERE_N_HAS_AFFINITY
+        const auto read_list = [](const std::string& path) {
+            std::ifstream file(path);
+            std::string line;
+            std::getline(file, line);
+            return parse_cpu_list(line);
+        };
+        const auto sysfs = std::string("/sys/devices/system/node/");
+        // node ids may have gaps, "online" lists them in the format of a CPU list
+        for (const auto id : read_list(sysfs + "online")) {
+            auto node = NumaNode{static_cast<unsigned>(id), {}};
+            for (const auto cpu : read_list(sysfs + "node" + std::to_string(id) + "/cpulist")) {
+                if (std::binary_search(usable.begin(), usable.end(), cpu)) {
+                    node.cpus.push_back(cpu);
+                }
+            }
+            if (!node.cpus.empty()) nodes.push_back(std::move(node));
+        }
+#endif
+        if (nodes.empty()) nodes.push_back(NumaNode{0, usable});
+        return nodes;
+    }
+
+    /**
+     * @brief First n points of the sphere sequence, generated by a pool of threads
+     *
+     * @param base Bases of the sequence values
+     * @param n Number of points
+     * @param opts Options
+     * @return BulkPoints
+     */
+    auto generate_bulk(span<const unsigned long> base, size_t n, const BulkOptions& opts)
+        -> BulkPoints {
+        SPHERE_N_TRACE_SCOPE("lds2::generate_bulk");
+        const auto m = base.size();
+        assert(m >= 2);
+        const auto dim = m + 1;
+        auto res = BulkPoints{};
+        res.n_points = n;
+        res.n_dim = dim;
+        // no value-initialization: the pages stay untouched until a worker writes them
+        res.data = std::make_unique_for_overwrite<double[]>(n * dim);
+        const auto out = span<double>(res.data.get(), n * dim);
+
+        const auto init = [&] {
+            return BulkBuffers{HaltonN(base), vector<double>(BULK_BLOCK * m)};
+        };
+        auto worker_loop = [&](BulkBuffers& w, size_t first, size_t count, const TpTables* tables) {
+            w.halton.reseed(first);
+            for (auto k = first; k < first + count; k += BULK_BLOCK) {
+                const auto len = std::min(BULK_BLOCK, first + count - k);
+                const auto ub = span<double>(w.u).first(len * m);
+                w.halton.pop_batch(ub);
+                map_batch(m, ub, out.subspan(k * dim, len * dim), opts, tables);
+            }
+        };
+
+        if (opts.numa_aware) {
+            const auto nodes = numa_topology();
+            const auto workers = plan_workers(nodes, opts.threads, n);
+            const auto replicate = m >= 3 && opts.inversion == Inversion::interp;
+            vector<std::optional<TpTables>> replicas(nodes.size());
+            vector<std::once_flag> built(nodes.size());
+            for (const auto& w : workers) {
+                if (!res.node_slices.empty() && res.node_slices.back().node == nodes[w.node].id) {
+                    res.node_slices.back().count += w.count;
+                } else {
+                    res.node_slices.push_back(NodeSlice{nodes[w.node].id, w.first, w.count});
+                }
+            }
+            // each slice belongs to its pinned worker, so the first exception of a
+            // worker (or of starting one) is kept and rethrown once all have joined
+            std::exception_ptr error;
+            std::mutex error_mutex;
+            const auto keep_error = [&] {
+                const auto lock = std::lock_guard(error_mutex);
+                if (!error) error = std::current_exception();
+            };
+            const auto run = [&](const BulkWorker& w) {
+                try {
+                    pin_to_cpu(w.cpu);
+                    const TpTables* tables = nullptr;
+                    if (replicate) {
+                        // built after pinning, so the copy is first-touched on this node
+                        std::call_once(built[w.node], [&] { replicas[w.node].emplace(m); });
+                        tables = &*replicas[w.node];
+                    }
+                    auto local = init();
+                    worker_loop(local, w.first, w.count, tables);
+                } catch (...) {
+                    keep_error();
+                }
+            };
+            vector<std::thread> pool;
+            pool.reserve(workers.size());
+            try {
+                for (const auto& w : workers) {
+                    pool.emplace_back([&run, w] { run(w); });
+                }
+            } catch (const std::system_error&) {
+                keep_error();
+            }
+            for (auto& thread : pool) {
+                thread.join();
+            }
+            if (error) std::rethrow_exception(error);
+        } else {
+            std::fill(out.begin(), out.end(), 0.0);  // every page first-touched here
+            res.node_slices.push_back(NodeSlice{numa_topology().front().id, 0, n});
+            const auto n_blocks = (n + BULK_BLOCK - 1) / BULK_BLOCK;
+            const auto threads = (opts.threads == 0) ? usable_cpus().size() : opts.threads;
+            detail::parallel_tasks(threads, n_blocks, init, [&](BulkBuffers& w, size_t i) {
+                const auto first = i * BULK_BLOCK;
+                worker_loop(w, first, std::min(BULK_BLOCK, n - first), nullptr);
+            });
+        }
+        return res;
+    }
+}  // namespace lds2
@@ -0,0 +1,89 @@
+#pragma once
+
+/** @file parallel.hpp
+ *  @brief Task pool of the multi-threaded drivers (internal, not installed).
+ */
+
+#include <algorithm>     // for max, min
+#include <atomic>        // for atomic
+#include <cstddef>       // for size_t
+#include <exception>     // for exception_ptr, current_exception, rethrow_exception
+#include <mutex>         // for mutex, lock_guard
+#include <system_error>  // for system_error
+#include <thread>        // for thread
+#include <vector>        // for vector
+
+namespace lds2::detail {
+    /**
+     * @brief Number of worker threads for n_tasks tasks
+     *
+     * @param threads Requested threads, 0 for the hardware concurrency
+     * @param n_tasks Number of tasks
+     * @return size_t
+     */
+    inline auto worker_count(size_t threads, size_t n_tasks) -> size_t {
+        if (threads == 0) threads = std::max(1U, std::thread::hardware_concurrency());
+        return std::max(size_t{1}, std::min(threads, n_tasks));
+    }
+
+    /**
+     * @brief Run fn(local, task) for task in [0, n_tasks) on a pool of threads
+     *
+     * Every worker, the calling thread included, builds its own state with
+     * `local = init()` and then claims tasks through an atomic counter, so
+     * uneven tasks balance; callers write per-task results and reduce them
+     * in task order. The first exception thrown by a worker moves the
+     * counter past the last task, so the other workers stop at their next
+     * claim, and is rethrown once all workers have joined.
+     *
+     * @param threads Requested threads, 0 for the hardware concurrency
+     * @param n_tasks Number of tasks
+     * @param init Builds the state of a worker
+     * @param fn Task body
+     */
+    template <typename Init, typename Fn>
+    auto parallel_tasks(size_t threads, size_t n_tasks, Init&& init, Fn&& fn) -> void {
+        std::atomic<size_t> next{0};
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto worker = [&] {
+            try {
+                auto local = init();
+                for (auto task = next.fetch_add(1); task < n_tasks; task = next.fetch_add(1)) {
+                    fn(local, task);
+                }
+            } catch (...) {
+                const auto lock = std::lock_guard(error_mutex);
+                if (!error) error = std::current_exception();
+                next.store(n_tasks);
+            }
+        };
+        const auto n_threads = worker_count(threads, n_tasks);
+        std::vector<std::thread> pool;
+        pool.reserve(n_threads - 1);
+        try {
+            for (auto t = size_t{1}; t < n_threads; ++t) {
+                pool.emplace_back(worker);
+            }
+        } catch (const std::system_error&) {
+            // out of threads: the ones already started and this one do all tasks
+        }
+        worker();
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        if (error) std::rethrow_exception(error);
+    }
+
+    /**
+     * @brief Run fn(task) for task in [0, n_tasks) on a pool of threads
+     *
+     * @param threads Requested threads, 0 for the hardware concurrency
+     * @param n_tasks Number of tasks
+     * @param fn Task body
+     */
+    template <typename Fn> auto parallel_tasks(size_t threads, size_t n_tasks, Fn&& fn) -> void {
+        parallel_tasks(
+            threads, n_tasks, [] { return 0; }, [&fn](int /*local*/, size_t task) { fn(task); });
+    }
+}  // namespace lds2::detail
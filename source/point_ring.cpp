@@ -0,0 +1,393 @@
+#include <array>                    // for array
+#include <atomic>                   // for atomic_ref, memory_order
+#include <chrono>                   // for steady_clock, seconds, milliseconds
+#include <cstddef>                  // for size_t, byte
+#include <cstdint>                  // for uint64_t
+#include <cstring>                  // for memset
+#include <memory>                   // for unique_ptr, make_unique
+#include <new>                      // for align_val_t
+#include <span>                     // for span
+#include <sphere_n/point_ring.hpp>  // for PointRing, PointBlock
+#include <stdexcept>                // for runtime_error, invalid_argument
+#include <string>                   // for string
+#include <thread>                   // for yield, sleep_for
+#include <utility>                  // for move, exchange
+
+#if SPHERE_N_HAS_SHM
+#    include <fcntl.h>     // for O_CREAT, O_EXCL, O_RDWR
+#    include <sys/mman.h>  // for mmap, munmap, shm_open, shm_unlink
+#    include <sys/stat.h>  // for fstat
+#    include <unistd.h>    // for ftruncate, close
+
+/** @brief How long `open_shared()` waits for the creator to publish the magic */
+static constexpr auto OPEN_TIMEOUT = std::chrono::seconds{1};
+#endif
+
+/** @brief "LDS2RING" in little-endian byte order */
+static constexpr std::uint64_t RING_MAGIC = 0x474E495232534C44ULL;
+
+/** @brief Alignment of the header fields and slots (one cache line) */
+static constexpr size_t LINE = 64;
+
+static_assert(std::atomic_ref<std::uint64_t>::is_always_lock_free,
+              "the ring needs address-free 64-bit atomics");
+
+/**
+ * @brief Header at the start of the ring region
+ *
+ * Plain integers, accessed through `std::atomic_ref` where they are shared,
+ * so the layout is the same in every process. The cursors sit on their own
+ * cache lines.
+ */
+struct RingHeader {
+    std::uint64_t magic;         ///< RING_MAGIC once the ring is initialized
+    std::uint64_t dim;           ///< coordinates per point
+    std::uint64_t block_points;  ///< points per block
+    std::uint64_t slots;         ///< number of slots
+    std::uint64_t slot_bytes;    ///< bytes per slot, a multiple of LINE
+    std::uint64_t total_bytes;   ///< bytes of the whole region
+    alignas(LINE) std::uint64_t claimed;  ///< next block to hand to a consumer
+    alignas(LINE) std::uint64_t published;  ///< blocks published so far
+    std::uint64_t closed;                   ///< nonzero after PointRing::close()
+};
+
+/**
+ * @brief Header at the start of each slot, followed by the point data
+ */
+struct SlotHeader {
+    std::uint64_t seq;    ///< see PointRing
+    std::uint64_t first;  ///< sequence index of the first point
+};
+
+static_assert(sizeof(RingHeader) % LINE == 0);
+static_assert(sizeof(SlotHeader) <= LINE);
+
+/**
+ * @brief Atomic view of a shared 64-bit word
+ *
+ * @param word The word
+ * @return std::atomic_ref<std::uint64_t>
+ */
+static auto shared_word(std::uint64_t& word) -> std::atomic_ref<std::uint64_t> {
+    return std::atomic_ref<std::uint64_t>(word);
+}
+
+/**
+ * @brief Bytes of one slot
+ *
+ * @param dim Coordinates per point
+ * @param block_points Points per block
+ * @return size_t
+ */
+static auto slot_bytes_for(size_t dim, size_t block_points) -> size_t {
+    const auto bytes = LINE + dim * block_points * sizeof(double);
+    return (bytes + LINE - 1) / LINE * LINE;
+}
+
+/**
+ * @brief Write the header and slot sequence words of a new ring
+ *
+ * The magic is stored last, with release ordering, so a process that sees
+ * it also sees the geometry.
+ *
+ * @param base Start of the zero-filled region
+ * @param dim Coordinates per point
+ * @param block_points Points per block
+ * @param slots Number of slots
+ */
+static void init_ring(std::byte* base, size_t dim, size_t block_points, size_t slots) {
+    auto* hdr = reinterpret_cast<RingHeader*>(base);
+    hdr->dim = dim;
+    hdr->block_points = block_points;
+    hdr->slots = slots;
+    hdr->slot_bytes = slot_bytes_for(dim, block_points);
+    hdr->total_bytes = sizeof(RingHeader) + slots * hdr->slot_bytes;
+    for (auto s = size_t{0}; s != slots; ++s) {
+        auto* slot = reinterpret_cast<SlotHeader*>(base + sizeof(RingHeader) + s * hdr->slot_bytes);
+        slot->seq = s;
+    }
+    shared_word(hdr->magic).store(RING_MAGIC, std::memory_order_release);
+}
+
+/**
+ * @brief Whether the sequence-word protocol works for a geometry
+ *
+ * With a single slot the release value i + slots equals the published
+ * value i + 1, so a published block could not be told from a free slot.
+ *
+ * @param dim Coordinates per point
+ * @param block_points Points per block
+ * @param slots Number of slots
+ * @return bool
+ */
+static auto valid_geometry(size_t dim, size_t block_points, size_t slots) -> bool {
+    return dim != 0 && block_points != 0 && slots >= 2;
+}
+
+/**
+ * @brief Check the geometry arguments of a new ring
+ *
+ * @param dim Coordinates per point
+ * @param block_points Points per block
+ * @param slots Number of slots
+ * @return size_t Bytes of the region
+ */
+static auto ring_bytes(size_t dim, size_t block_points, size_t slots) -> size_t {
+    if (!valid_geometry(dim, block_points, slots)) {
+        throw std::invalid_argument(
+            "PointRing: dim and block_points must be positive, and slots at least 2");
+    }
+    return sizeof(RingHeader) + slots * slot_bytes_for(dim, block_points);
+}
+
+namespace lds2 {
+    /**
+     * @brief Owner of the memory of a ring
+     *
+     * Either an aligned heap buffer or a shared-memory mapping; the creator
+     * of a shared ring also unlinks the object.
+     */
+    struct PointRing::Mapping {
+        std::byte* addr = nullptr;
+        size_t bytes = 0;
+        bool heap = false;
+        std::string unlink_name;
+
+        Mapping() = default;
+        Mapping(const Mapping&) = delete;
+        auto operator=(const Mapping&) -> Mapping& = delete;
+
+        ~Mapping() {
+            if (this->heap) {
+                ::operator delete(this->addr, std::align_val_t{LINE});
+                return;
+            }
+#if SPHERE_N_HAS_SHM
+            if (this->addr != nullptr) ::munmap(this->addr, this->bytes);
+            if (!this->unlink_name.empty()) ::shm_unlink(this->unlink_name.c_str());
+#endif
+        }
+    };
+
+    PointRing::PointRing(std::unique_ptr<Mapping> map) : map{std::move(map)} {
+        this->base = this->map->addr;
+        this->next_block = shared_word(reinterpret_cast<RingHeader*>(this->base)->published)
+                               .load(std::memory_order_acquire);
+    }
+
+    PointRing::PointRing(PointRing&&) noexcept = default;
+    auto PointRing::operator=(PointRing&&) noexcept -> PointRing& = default;
+    PointRing::~PointRing() = default;
+
+    /**
+     * @brief Ring in process memory
+     *
+     * @param dim Coordinates per point
+     * @param block_points Points per block
+     * @param slots Number of slots
+     * @return PointRing
+     */
+    auto PointRing::create_local(size_t dim, size_t block_points, size_t slots) -> PointRing {
+        auto map = std::make_unique<Mapping>();
+        map->bytes = ring_bytes(dim, block_points, slots);
+        map->addr = static_cast<std::byte*>(::operator new(map->bytes, std::align_val_t{LINE}));
+        map->heap = true;
+        std::memset(map->addr, 0, map->bytes);
+        init_ring(map->addr, dim, block_points, slots);
+        return PointRing(std::move(map));
+    }
+
+#if SPHERE_N_HAS_SHM
+    /**
+     * @brief Create a ring in a new POSIX shared-memory object
+     *
+     * @param name Name of the object
+     * @param dim Coordinates per point
+     * @param block_points Points per block
+     * @param slots Number of slots
+     * @return PointRing
+     */
+    auto PointRing::create_shared(const std::string& name, size_t dim, size_t block_points,
+                                  size_t slots) -> PointRing {
+        const auto bytes = ring_bytes(dim, block_points, slots);
+        const auto fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error("PointRing: cannot create " + name);
+        auto map = std::make_unique<Mapping>();
+        map->unlink_name = name;  // unlinked by ~Mapping, also on the error paths below
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("PointRing: cannot size " + name);
+        }
+        auto* addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) throw std::runtime_error("PointRing: cannot map " + name);
+        map->addr = static_cast<std::byte*>(addr);
+        map->bytes = bytes;
+        init_ring(map->addr, dim, block_points, slots);  // ftruncate zero-filled it
+        return PointRing(std::move(map));
+    }
+
+    /**
+     * @brief Attach to a ring created by `create_shared()`
+     *
+     * @param name Name of the object
+     * @return PointRing
+     */
+    auto PointRing::open_shared(const std::string& name) -> PointRing {
+        const auto fd = ::shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) throw std::runtime_error("PointRing: cannot open " + name);
+        auto map = std::make_unique<Mapping>();
+        // the creator sizes the object and then publishes the magic, so an opener
+        // racing it can see an empty object or a zero magic for a moment
+        const auto deadline = std::chrono::steady_clock::now() + OPEN_TIMEOUT;
+        for (;;) {
+            struct stat st {};
+            if (::fstat(fd, &st) != 0) {
+                ::close(fd);
+                throw std::runtime_error("PointRing: cannot open " + name);
+            }
+            const auto bytes = static_cast<size_t>(st.st_size);
+            if (bytes >= sizeof(RingHeader)) {
+                auto* addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (addr == MAP_FAILED) {
+                    ::close(fd);
+                    throw std::runtime_error("PointRing: cannot map " + name);
+                }
+                map->addr = static_cast<std::byte*>(addr);
+                map->bytes = bytes;
+                auto* hdr = reinterpret_cast<RingHeader*>(map->addr);
+                if (shared_word(hdr->magic).load(std::memory_order_acquire) != 0) break;
+                ::munmap(std::exchange(map->addr, nullptr), bytes);
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                ::close(fd);
+                throw std::runtime_error("PointRing: " + name + " is not ready");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        ::close(fd);
+        auto* hdr = reinterpret_cast<RingHeader*>(map->addr);
+        if (shared_word(hdr->magic).load(std::memory_order_acquire) != RING_MAGIC
+            || !valid_geometry(hdr->dim, hdr->block_points, hdr->slots)
+            || hdr->total_bytes != map->bytes
+            || hdr->slot_bytes != slot_bytes_for(hdr->dim, hdr->block_points)
+            || hdr->total_bytes != ring_bytes(hdr->dim, hdr->block_points, hdr->slots)) {
+            throw std::runtime_error("PointRing: " + name + " is not a ring");
+        }
+        return PointRing(std::move(map));
+    }
+#else
+    auto PointRing::create_shared(const std::string& /*name*/, size_t /*dim*/,
+                                  size_t /*block_points*/, size_t /*slots*/) -> PointRing {
+        throw std::runtime_error("PointRing: shared memory is not supported on this platform");
+    }
+
+    auto PointRing::open_shared(const std::string& /*name*/) -> PointRing {
+        throw std::runtime_error("PointRing: shared memory is not supported on this platform");
+    }
+#endif
+
+    auto PointRing::slot_seq(std::uint64_t block) const -> std::uint64_t* {
+        const auto* hdr = reinterpret_cast<const RingHeader*>(this->base);
+        auto* slot = this->base + sizeof(RingHeader) + (block % hdr->slots) * hdr->slot_bytes;
+        return &reinterpret_cast<SlotHeader*>(slot)->seq;
+    }
+
+    auto PointRing::slot_data(std::uint64_t block) const -> double* {
+        const auto* hdr = reinterpret_cast<const RingHeader*>(this->base);
+        auto* slot = this->base + sizeof(RingHeader) + (block % hdr->slots) * hdr->slot_bytes;
+        return reinterpret_cast<double*>(slot + LINE);
+    }
+
+    /**
+     * @brief Wait for the next free slot and return its buffer
+     *
+     * @return span<double>
+     */
+    auto PointRing::begin_block() -> span<double> {
+        const auto seq = shared_word(*this->slot_seq(this->next_block));
+        while (seq.load(std::memory_order_acquire) != this->next_block) {
+            std::this_thread::yield();
+        }
+        return {this->slot_data(this->next_block), this->block_points() * this->dim()};
+    }
+
+    /**
+     * @brief Publish the block filled after `begin_block()`
+     *
+     * @param first_index Sequence index of the first point in the block
+     */
+    auto PointRing::commit_block(unsigned long first_index) -> void {
+        auto* hdr = reinterpret_cast<RingHeader*>(this->base);
+        auto* seq = this->slot_seq(this->next_block);
+        reinterpret_cast<SlotHeader*>(seq)->first = first_index;
+        shared_word(*seq).store(this->next_block + 1, std::memory_order_release);
+        ++this->next_block;
+        shared_word(hdr->published).store(this->next_block, std::memory_order_release);
+    }
+
+    /**
+     * @brief Mark the end of the stream
+     */
+    auto PointRing::close() -> void {
+        auto* hdr = reinterpret_cast<RingHeader*>(this->base);
+        shared_word(hdr->closed).store(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Claim the next unclaimed block
+     *
+     * @param res The claimed block; a block it held is released first
+     * @return bool false once the ring is closed and drained
+     */
+    auto PointRing::claim(PointBlock& res) -> bool {
+        res.release();  // a consumer waiting while holding a slot could stall the producer
+        auto* hdr = reinterpret_cast<RingHeader*>(this->base);
+        const auto block = shared_word(hdr->claimed).fetch_add(1, std::memory_order_relaxed);
+        const auto seq = shared_word(*this->slot_seq(block));
+        while (seq.load(std::memory_order_acquire) != block + 1) {
+            if (shared_word(hdr->closed).load(std::memory_order_acquire) != 0
+                && block >= shared_word(hdr->published).load(std::memory_order_acquire)) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        const auto first = reinterpret_cast<const SlotHeader*>(this->slot_seq(block))->first;
+        res = PointBlock(this, block, first,
+                         {this->slot_data(block), this->block_points() * this->dim()});
+        return true;
+    }
+
+    auto PointRing::dim() const -> size_t {
+        return reinterpret_cast<const RingHeader*>(this->base)->dim;
+    }
+
+    auto PointRing::block_points() const -> size_t {
+        return reinterpret_cast<const RingHeader*>(this->base)->block_points;
+    }
+
+    auto PointRing::slots() const -> size_t {
+        return reinterpret_cast<const RingHeader*>(this->base)->slots;
+    }
+
+    auto PointBlock::operator=(PointBlock&& other) noexcept -> PointBlock& {
+        if (this != &other) {
+            this->release();
+            this->ring = std::exchange(other.ring, nullptr);
+            this->block = other.block;
+            this->first = other.first;
+            this->pts = other.pts;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Hand the slot back to the producer
+     */
+    auto PointBlock::release() -> void {
+        if (this->ring == nullptr) return;
+        shared_word(*this->ring->slot_seq(this->block))
+            .store(this->block + this->ring->slots(), std::memory_order_release);
+        this->ring = nullptr;
+    }
+}  // namespace lds2
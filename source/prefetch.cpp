@@ -0,0 +1,201 @@
+#include <atomic>                 // for atomic, memory_order
+#include <cassert>                // for assert
+#include <cstddef>                // for size_t
+#include <cstdint>                // for uint32_t, uint64_t
+#include <memory>                 // for make_unique
+#include <span>                   // for span
+#include <sphere_n/halton_n.hpp>  // for HaltonN
+#include <sphere_n/prefetch.hpp>  // for Prefetcher, PrefetchOptions, WaitPolicy
+#include <sphere_n/sphere_n.hpp>  // for map_points, Mapping
+#include <stdexcept>              // for invalid_argument
+#include <thread>                 // for thread, yield
+#include <vector>                 // for vector
+
+using std::span;
+using std::vector;
+
+/** @brief Size of a cache line, the distance between the counters of the two sides */
+static constexpr size_t LINE = 64;
+
+/**
+ * @brief Wait once before rechecking a condition, as selected by the policy
+ *
+ * For `WaitPolicy::park` the caller sleeps until `word` differs from `seen`.
+ *
+ * @tparam T Type of the watched word
+ * @param policy The policy
+ * @param word Word the other side changes and notifies
+ * @param seen Value of `word` read before the condition was checked
+ */
+template <typename T>
+static auto wait_once(lds2::WaitPolicy policy, const std::atomic<T>& word, T seen) -> void {
+    switch (policy) {
+        case lds2::WaitPolicy::spin:
+            break;
+        case lds2::WaitPolicy::yield:
+            std::this_thread::yield();
+            break;
+        case lds2::WaitPolicy::park:
+            word.wait(seen, std::memory_order_acquire);
+            break;
+    }
+}
+
+namespace lds2 {
+    /**
+     * @brief Ring and control words shared by the consumer and the producer thread
+     *
+     * `head` is written by the producer only, `tail` by the consumer only;
+     * `wake` is bumped by the consumer whenever the producer may have to
+     * wake up (a released block, shutdown). The fields after `producer` are
+     * private to the consumer.
+     */
+    struct Prefetcher::Shared {
+        vector<unsigned long> base;
+        PrefetchOptions opts;
+        size_t m;
+        size_t dim;
+        vector<double> data;          ///< depth blocks of block_points * dim values
+        vector<std::uint64_t> epoch_of;  ///< epoch each slot was generated for
+
+        alignas(LINE) std::atomic<std::uint64_t> head{0};  ///< blocks published
+        alignas(LINE) std::atomic<std::uint64_t> tail{0};  ///< blocks released
+        alignas(LINE) std::atomic<std::uint64_t> epoch{0};  ///< bumped by reseed()
+        std::atomic<unsigned long> seed{0};                 ///< seed of the latest epoch
+        std::atomic<std::uint32_t> wake{0};
+        std::atomic<bool> stop{false};
+        std::thread producer;
+
+        alignas(LINE) std::uint64_t seen_head = 0;  ///< consumer's copy of head
+        std::uint64_t want_epoch = 0;               ///< epoch the consumer accepts
+        bool holding = false;                       ///< block `tail` is being read
+
+        Shared(span<const unsigned long> base, const PrefetchOptions& opts)
+            : base(base.begin(), base.end()),
+              opts{opts},
+              m{base.size()},
+              dim{base.size() + 1},
+              data(opts.depth * opts.block_points * (base.size() + 1)),
+              epoch_of(opts.depth) {}
+
+        auto slot(std::uint64_t block) -> span<double> {
+            const auto len = this->opts.block_points * this->dim;
+            return span<double>(this->data).subspan((block % this->opts.depth) * len, len);
+        }
+
+        auto notify_producer() -> void {
+            if (this->opts.wait != WaitPolicy::park) return;
+            this->wake.fetch_add(1, std::memory_order_release);
+            this->wake.notify_one();
+        }
+
+        auto produce() -> void;
+    };
+
+    /**
+     * @brief Body of the producer thread
+     *
+     * Waits for a free slot, switches to the latest seed if the epoch
+     * changed, fills the slot with one block and publishes it.
+     */
+    auto Prefetcher::Shared::produce() -> void {
+        auto halton = HaltonN(this->base);
+        vector<double> u(this->opts.block_points * this->m);
+        auto head_local = std::uint64_t{0};
+        auto seen_tail = std::uint64_t{0};
+        auto epoch_local = std::uint64_t{0};
+        while (true) {
+            while (head_local - seen_tail >= this->opts.depth) {
+                const auto w = this->wake.load(std::memory_order_acquire);
+                seen_tail = this->tail.load(std::memory_order_acquire);
+                if (this->stop.load(std::memory_order_acquire)) return;
+                if (head_local - seen_tail < this->opts.depth) break;
+                wait_once(this->opts.wait, this->wake, w);
+            }
+            if (this->stop.load(std::memory_order_acquire)) return;
+            const auto e = this->epoch.load(std::memory_order_acquire);
+            if (e != epoch_local) {
+                epoch_local = e;
+                halton.reseed(this->seed.load(std::memory_order_relaxed));
+            }
+            const auto x = this->slot(head_local);
+            halton.pop_batch(u);
+            map_points(this->opts.mapping, this->m, u, x, this->opts.inversion,
+                       this->opts.accuracy);
+            this->epoch_of[head_local % this->opts.depth] = epoch_local;
+            this->head.store(++head_local, std::memory_order_release);
+            if (this->opts.wait == WaitPolicy::park) this->head.notify_one();
+        }
+    }
+
+    /**
+     * @brief Start the producer thread
+     *
+     * @param base Bases of the sequence values
+     * @param opts Options
+     */
+    Prefetcher::Prefetcher(span<const unsigned long> base, const PrefetchOptions& opts)
+        : n_dim{base.size() + 1} {
+        assert(base.size() >= 2);
+        if (opts.depth == 0 || opts.block_points == 0) {
+            throw std::invalid_argument("Prefetcher: depth and block_points must be positive");
+        }
+        this->shared = std::make_unique<Shared>(base, opts);
+        this->shared->producer = std::thread([s = this->shared.get()] { s->produce(); });
+    }
+
+    /**
+     * @brief Stop and join the producer thread
+     */
+    Prefetcher::~Prefetcher() {
+        auto& s = *this->shared;
+        s.stop.store(true, std::memory_order_release);
+        s.wake.fetch_add(1, std::memory_order_release);
+        s.wake.notify_one();
+        s.producer.join();
+    }
+
+    /**
+     * @brief Release the used-up block and take the next one of the current epoch
+     */
+    auto Prefetcher::refill() -> void {
+        auto& s = *this->shared;
+        auto tail = s.tail.load(std::memory_order_relaxed);
+        if (s.holding) {
+            s.tail.store(++tail, std::memory_order_release);
+            s.notify_producer();
+            s.holding = false;
+        }
+        while (true) {
+            if (s.seen_head == tail) {
+                s.seen_head = s.head.load(std::memory_order_acquire);
+                if (s.seen_head == tail) {
+                    ++this->n_stalls;
+                    do {
+                        wait_once(s.opts.wait, s.head, tail);
+                        s.seen_head = s.head.load(std::memory_order_acquire);
+                    } while (s.seen_head == tail);
+                }
+            }
+            if (s.epoch_of[tail % s.opts.depth] == s.want_epoch) break;
+            s.tail.store(++tail, std::memory_order_release);  // generated before a reseed
+            s.notify_producer();
+        }
+        s.holding = true;
+        const auto blk = s.slot(tail);
+        this->pos = blk.data();
+        this->end = blk.data() + blk.size();
+    }
+
+    /**
+     * @brief Restart the sequence after `seed` points
+     *
+     * @param seed The seed value to reset to
+     */
+    auto Prefetcher::reseed(unsigned long seed) -> void {
+        auto& s = *this->shared;
+        s.seed.store(seed, std::memory_order_relaxed);
+        s.want_epoch = s.epoch.fetch_add(1, std::memory_order_release) + 1;
+        this->pos = this->end;  // the rest of the current block is stale
+    }
+}  // namespace lds2
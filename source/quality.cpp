@@ -0,0 +1,513 @@
+#include <algorithm>              // for sort, min, max, clamp, fill
+#include <cassert>                // for assert
+#include <cmath>                  // for sqrt, log, pow, acos, cos, floor
+#include <cstddef>                // for size_t
+#include <cstdint>                // for uint64_t
+#include <functional>             // for greater
+#include <limits>                 // for numeric_limits
+#include <numbers>                // for pi
+#include <random>                 // for mt19937_64
+#include <span>                   // for span
+#include <sphere_n/quality.hpp>   // for QualityOptions, QualityReport
+#include <sphere_n/sphere_n.hpp>  // for tp_value
+#include <vector>                 // for vector
+
+#include "parallel.hpp"  // for parallel_tasks
+
+using lds2::detail::parallel_tasks;
+using std::span;
+using std::vector;
+
+/** @brief Rows per task of the energy kernel */
+static constexpr size_t ROW_BLOCK = 32;
+
+/** @brief Columns per distance batch; the batch lives in a stack buffer */
+static constexpr size_t COL_BLOCK = 256;
+
+/** @brief Coordinates used by the cell grid */
+static constexpr size_t GRID_DIMS = 3;
+
+/**
+ * @brief Coordinate-major copy of row-major points
+ *
+ * @param pts Row-major points
+ * @param dim Coordinates per point
+ * @return vector<double> Coordinate d of point i at d * N + i
+ */
+static auto to_soa(span<const double> pts, size_t dim) -> vector<double> {
+    const auto n = pts.size() / dim;
+    vector<double> soa(pts.size());
+    for (auto i = size_t{0}; i != n; ++i) {
+        for (auto d = size_t{0}; d != dim; ++d) {
+            soa[d * n + i] = pts[i * dim + d];
+        }
+    }
+    return soa;
+}
+
+/**
+ * @brief Uniform random points on the unit sphere, reproducible across platforms
+ *
+ * Normal coordinates by the Box-Muller transform of `std::mt19937_64`
+ * output (the standard distributions are implementation-defined),
+ * normalized.
+ *
+ * @param n Number of points
+ * @param dim Coordinates per point
+ * @param seed Seed of the generator
+ * @return vector<double> Row-major points
+ */
+static auto random_sphere_points(size_t n, size_t dim, std::uint64_t seed) -> vector<double> {
+    auto rng = std::mt19937_64(seed);
+    auto uniform = [&rng] { return (static_cast<double>(rng() >> 11U) + 0.5) * 0x1p-53; };
+    vector<double> res(n * dim);
+    for (auto i = size_t{0}; i != n; ++i) {
+        auto norm2 = 0.0;
+        for (auto d = size_t{0}; d != dim; ++d) {
+            const auto r = std::sqrt(-2.0 * std::log(uniform()));
+            const auto v = r * std::cos(2.0 * std::numbers::pi * uniform());
+            res[i * dim + d] = v;
+            norm2 += v * v;
+        }
+        const auto inv = 1.0 / std::sqrt(norm2);
+        for (auto d = size_t{0}; d != dim; ++d) {
+            res[i * dim + d] *= inv;
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief Uniform grid of cells over the first GRID_DIMS coordinates
+ *
+ * Points are counting-sorted by cell into a coordinate-major copy, so each
+ * cell is a contiguous run of every coordinate. The distance between two
+ * points is at least the distance of their projections, so a point in a
+ * cell r rings away from the query cell (Chebyshev distance in cells) is
+ * at least (r - 1) h away, and the ring search of `nearest()` is exact.
+ *
+ * @verbatim
+ *   ring 2  ring 1  ring 0
+ *   +---+---+---+---+---+
+ *   | 2 | 2 | 2 | 2 | 2 |
+ *   +---+---+---+---+---+
+ *   | 2 | 1 | 1 | 1 | 2 |
+ *   +---+---+---+---+---+
+ *   | 2 | 1 | q | 1 | 2 |     stop after ring r once best <= r h
+ *   +---+---+---+---+---+
+ * @endverbatim
+ */
+class CellGrid {
+    size_t dim;
+    size_t n;
+    size_t k;                 ///< projected coordinates
+    size_t g;                 ///< cells per axis
+    double h;                 ///< cell width
+    vector<size_t> start;     ///< first point of each cell, g^k + 1 entries
+    vector<double> soa;       ///< coordinate-major points, sorted by cell
+    size_t max_occupancy = 0;
+
+    auto cell_of(double x) const -> size_t {
+        const auto c = std::floor((x + 1.0) / this->h);
+        return static_cast<size_t>(std::clamp(c, 0.0, static_cast<double>(this->g - 1)));
+    }
+
+  public:
+    /**
+     * @brief Build the grid
+     *
+     * The number of cells is chosen for a few points per occupied cell:
+     * when every coordinate is projected the points lie on a (k-1)-surface
+     * of the cube, otherwise they fill it.
+     *
+     * @param pts Row-major points with coordinates in [-1, 1]
+     * @param dim Coordinates per point
+     */
+    CellGrid(span<const double> pts, size_t dim)
+        : dim{dim}, n{pts.size() / dim}, k{std::min(dim, GRID_DIMS)} {
+        const auto eff = (this->k == dim) ? this->k - 1 : this->k;
+        const auto nd = static_cast<double>(this->n);
+        auto gd = std::pow(nd / 4.0, 1.0 / static_cast<double>(std::max(eff, size_t{1})));
+        gd = std::min(gd, std::pow(8.0 * nd, 1.0 / static_cast<double>(this->k)));
+        this->g = std::max(size_t{1}, static_cast<size_t>(gd));
+        this->h = 2.0 / static_cast<double>(this->g);
+
+        auto n_cells = size_t{1};
+        for (auto a = size_t{0}; a != this->k; ++a) {
+            n_cells *= this->g;
+        }
+        vector<size_t> cell(this->n);
+        this->start.assign(n_cells + 1, 0);
+        for (auto i = size_t{0}; i != this->n; ++i) {
+            auto c = size_t{0};
+            for (auto a = size_t{0}; a != this->k; ++a) {
+                c = c * this->g + this->cell_of(pts[i * dim + a]);
+            }
+            cell[i] = c;
+            ++this->start[c + 1];
+        }
+        for (auto c = size_t{0}; c != n_cells; ++c) {
+            this->max_occupancy = std::max(this->max_occupancy, this->start[c + 1]);
+            this->start[c + 1] += this->start[c];
+        }
+        auto fill = vector<size_t>(this->start.begin(), this->start.end() - 1);
+        this->soa.resize(pts.size());
+        for (auto i = size_t{0}; i != this->n; ++i) {
+            const auto j = fill[cell[i]]++;
+            for (auto d = size_t{0}; d != dim; ++d) {
+                this->soa[d * this->n + j] = pts[i * dim + d];
+            }
+        }
+    }
+
+    /**
+     * @brief Number of points
+     * @return size_t
+     */
+    auto size() const -> size_t { return this->n; }
+
+    /**
+     * @brief Copy point j of the sorted order into q
+     *
+     * @param j Index in the sorted order
+     * @param q Output buffer of `dim` values
+     */
+    auto point(size_t j, double* q) const -> void {
+        for (auto d = size_t{0}; d != this->dim; ++d) {
+            q[d] = this->soa[d * this->n + j];
+        }
+    }
+
+    /**
+     * @brief Squared distance from q to the nearest point other than `skip`
+     *
+     * The search also stops once no unvisited point can be closer than
+     * `bound`; the result is then only known to be at least `bound`.
+     *
+     * @param q Query point, `dim` values
+     * @param skip Index in the sorted order to exclude, or n for none
+     * @param scratch Buffer of at least `max_occupancy` values
+     * @param bound Squared distance of no interest
+     * @return double
+     */
+    auto nearest(const double* q, size_t skip, vector<double>& scratch,
+                 double bound = std::numeric_limits<double>::infinity()) const -> double {
+        scratch.resize(this->max_occupancy);
+        size_t qc[GRID_DIMS];
+        for (auto a = size_t{0}; a != this->k; ++a) {
+            qc[a] = this->cell_of(q[a]);
+        }
+        auto best = std::numeric_limits<double>::infinity();
+        for (auto r = size_t{0}; r <= this->g; ++r) {
+            // odometer over the cube of offsets [-r, r]^k, visiting the shell only
+            long off[GRID_DIMS];
+            const auto ri = static_cast<long>(r);
+            std::fill(off, off + this->k, -ri);
+            for (;;) {
+                auto on_shell = false;
+                auto inside = true;
+                auto c = size_t{0};
+                for (auto a = size_t{0}; a != this->k; ++a) {
+                    on_shell = on_shell || off[a] == -ri || off[a] == ri;
+                    const auto ca = static_cast<long>(qc[a]) + off[a];
+                    inside = inside && ca >= 0 && ca < static_cast<long>(this->g);
+                    c = c * this->g + static_cast<size_t>(ca);
+                }
+                if (on_shell && inside) {
+                    best = std::min(best, this->scan_cell(c, q, skip, scratch));
+                }
+                auto a = size_t{0};
+                while (a != this->k && off[a] == ri) {
+                    off[a++] = -ri;
+                }
+                if (a == this->k) break;
+                ++off[a];
+            }
+            const auto reach = static_cast<double>(r) * this->h;
+            if (std::min(best, bound) <= reach * reach) break;
+        }
+        return best;
+    }
+
+  private:
+    /**
+     * @brief Squared distance from q to the nearest point of cell c other than `skip`
+     */
+    auto scan_cell(size_t c, const double* q, size_t skip, vector<double>& scratch) const
+        -> double {
+        const auto j0 = this->start[c];
+        const auto len = this->start[c + 1] - j0;
+        auto* acc = scratch.data();
+        std::fill(acc, acc + len, 0.0);
+        for (auto d = size_t{0}; d != this->dim; ++d) {
+            const auto* x = &this->soa[d * this->n + j0];
+            const auto qd = q[d];
+            for (auto j = size_t{0}; j != len; ++j) {
+                const auto diff = x[j] - qd;
+                acc[j] += diff * diff;
+            }
+        }
+        if (skip >= j0 && skip < j0 + len) {
+            acc[skip - j0] = std::numeric_limits<double>::infinity();
+        }
+        auto best = std::numeric_limits<double>::infinity();
+        for (auto j = size_t{0}; j != len; ++j) {
+            best = std::min(best, acc[j]);
+        }
+        return best;
+    }
+};
+
+/**
+ * @brief Smallest distance between two points of the grid
+ */
+static auto min_distance_grid(const CellGrid& grid, size_t dim, size_t threads) -> double {
+    const auto n = grid.size();
+    const auto n_tasks = (n + COL_BLOCK - 1) / COL_BLOCK;
+    vector<double> best(n_tasks);
+    parallel_tasks(threads, n_tasks, [&grid, &best, dim, n](size_t task) {
+        vector<double> q(dim);
+        vector<double> scratch;
+        auto res = std::numeric_limits<double>::infinity();
+        for (auto j = task * COL_BLOCK; j != std::min(n, (task + 1) * COL_BLOCK); ++j) {
+            grid.point(j, q.data());
+            res = std::min(res, grid.nearest(q.data(), j, scratch, res));
+        }
+        best[task] = res;
+    });
+    return std::sqrt(*std::min_element(best.begin(), best.end()));
+}
+
+/**
+ * @brief Largest distance from a probe point to its nearest point of the grid
+ */
+static auto covering_radius_grid(const CellGrid& grid, size_t dim, const lds2::QualityOptions& opts)
+    -> double {
+    const auto probes = random_sphere_points(opts.n_probes, dim, opts.seed);
+    const auto n_tasks = (opts.n_probes + COL_BLOCK - 1) / COL_BLOCK;
+    vector<double> worst(n_tasks, 0.0);
+    parallel_tasks(opts.threads, n_tasks, [&grid, &probes, &worst, &opts, dim](size_t task) {
+        vector<double> scratch;
+        auto res = 0.0;
+        for (auto p = task * COL_BLOCK; p != std::min(opts.n_probes, (task + 1) * COL_BLOCK);
+             ++p) {
+            res = std::max(res, grid.nearest(&probes[p * dim], grid.size(), scratch));
+        }
+        worst[task] = res;
+    });
+    return std::sqrt(*std::max_element(worst.begin(), worst.end()));
+}
+
+/**
+ * @brief Sum of a batch with four independent accumulators
+ *
+ * Breaks the dependency chain of a plain running sum; the order of the
+ * additions is fixed, so the result is reproducible.
+ *
+ * @param val Values
+ * @param len Number of values
+ * @return double
+ */
+static auto sum4(const double* val, size_t len) -> double {
+    double acc[4] = {0.0, 0.0, 0.0, 0.0};
+    auto j = size_t{0};
+    for (; j + 4 <= len; j += 4) {
+        for (auto l = 0U; l != 4U; ++l) {
+            acc[l] += val[j + l];
+        }
+    }
+    for (; j != len; ++j) {
+        acc[0] += val[j];
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+/**
+ * @brief Sum of the Riesz kernel over a batch of squared distances
+ *
+ * Integer s is split into r2^-(s/2) by repeated multiplication and one
+ * square root for odd s, with the branches outside the loops so that they
+ * vectorize; other s use std::pow, s == 0 the logarithm.
+ *
+ * @param r2 Squared distances, overwritten
+ * @param len Number of distances, at most COL_BLOCK
+ * @param s Riesz exponent
+ * @return double
+ */
+static auto riesz_sum(double* r2, size_t len, double s) -> double {
+    double val[COL_BLOCK];
+    if (s == 0.0) {
+        for (auto j = size_t{0}; j != len; ++j) {
+            val[j] = -0.5 * std::log(r2[j]);
+        }
+    } else if (s != std::floor(s) || s < 0.0) {
+        for (auto j = size_t{0}; j != len; ++j) {
+            val[j] = std::pow(r2[j], -0.5 * s);
+        }
+    } else {
+        const auto si = static_cast<unsigned long>(s);
+        for (auto j = size_t{0}; j != len; ++j) {
+            r2[j] = 1.0 / r2[j];
+        }
+        if (si % 2 == 1) {
+            for (auto j = size_t{0}; j != len; ++j) {
+                val[j] = std::sqrt(r2[j]);
+            }
+        } else {
+            std::fill(val, val + len, 1.0);
+        }
+        for (auto p = size_t{0}; p != si / 2; ++p) {
+            for (auto j = size_t{0}; j != len; ++j) {
+                val[j] *= r2[j];
+            }
+        }
+    }
+    return sum4(val, len);
+}
+
+/**
+ * @brief Riesz energy of all pairs i < j, blocked over rows
+ */
+static auto riesz_energy_soa(const vector<double>& soa, size_t n, size_t dim,
+                             const lds2::QualityOptions& opts) -> double {
+    const auto n_tasks = (n + ROW_BLOCK - 1) / ROW_BLOCK;
+    vector<double> partial(n_tasks, 0.0);
+    parallel_tasks(opts.threads, n_tasks, [&soa, &partial, &opts, n, dim](size_t task) {
+        double r2[COL_BLOCK];
+        auto sum = 0.0;
+        for (auto i = task * ROW_BLOCK; i != std::min(n, (task + 1) * ROW_BLOCK); ++i) {
+            for (auto j0 = i + 1; j0 < n; j0 += COL_BLOCK) {
+                const auto len = std::min(COL_BLOCK, n - j0);
+                std::fill(r2, r2 + len, 0.0);
+                for (auto d = size_t{0}; d != dim; ++d) {
+                    const auto* x = &soa[d * n + j0];
+                    const auto xi = soa[d * n + i];
+                    for (auto j = size_t{0}; j != len; ++j) {
+                        const auto diff = x[j] - xi;
+                        r2[j] += diff * diff;
+                    }
+                }
+                sum += riesz_sum(r2, len, opts.riesz_s);
+            }
+        }
+        partial[task] = sum;
+    });
+    auto total = 0.0;
+    for (const auto v : partial) {
+        total += v;
+    }
+    return total;
+}
+
+/**
+ * @brief Largest cap discrepancy over random centers
+ */
+static auto cap_discrepancy_soa(const vector<double>& soa, size_t n, size_t dim,
+                                const lds2::QualityOptions& opts) -> double {
+    assert(dim >= 2);
+    const auto centers = random_sphere_points(opts.n_caps, dim, opts.seed ^ 0x9E3779B97F4A7C15ULL);
+    // normalized area of the cap {<x, c> >= t} on S^(dim-1)
+    const auto tpn = dim - 2;
+    const auto tp0 = lds2::tp_value(tpn, 0.0);
+    const auto tp_scale = 1.0 / (lds2::tp_value(tpn, std::numbers::pi) - tp0);
+    const auto nd = static_cast<double>(n);
+    vector<double> worst(opts.n_caps, 0.0);
+    parallel_tasks(opts.threads, opts.n_caps, [&](size_t cap) {
+        vector<double> t(n, 0.0);
+        for (auto d = size_t{0}; d != dim; ++d) {
+            const auto* x = &soa[d * n];
+            const auto cd = centers[cap * dim + d];
+            for (auto i = size_t{0}; i != n; ++i) {
+                t[i] += x[i] * cd;
+            }
+        }
+        std::sort(t.begin(), t.end(), std::greater<>{});
+        auto res = 0.0;
+        for (auto i = size_t{0}; i != n; ++i) {
+            const auto theta = std::acos(std::clamp(t[i], -1.0, 1.0));
+            const auto area = (lds2::tp_value(tpn, theta) - tp0) * tp_scale;
+            const auto k = static_cast<double>(i + 1);
+            res = std::max(res, std::max(k / nd - area, area - (k - 1.0) / nd));
+        }
+        worst[cap] = res;
+    });
+    return *std::max_element(worst.begin(), worst.end());
+}
+
+namespace lds2 {
+    /**
+     * @brief Spherical cap discrepancy, estimated over random cap centers
+     *
+     * @param pts Row-major points on the unit sphere
+     * @param dim Coordinates per point
+     * @param opts Parameters
+     * @return double
+     */
+    auto cap_discrepancy(span<const double> pts, size_t dim, const QualityOptions& opts)
+        -> double {
+        assert(pts.size() % dim == 0 && opts.n_caps > 0);
+        return cap_discrepancy_soa(to_soa(pts, dim), pts.size() / dim, dim, opts);
+    }
+
+    /**
+     * @brief Riesz s-energy
+     *
+     * @param pts Row-major points
+     * @param dim Coordinates per point
+     * @param opts Parameters
+     * @return double
+     */
+    auto riesz_energy(span<const double> pts, size_t dim, const QualityOptions& opts) -> double {
+        assert(pts.size() % dim == 0);
+        return riesz_energy_soa(to_soa(pts, dim), pts.size() / dim, dim, opts);
+    }
+
+    /**
+     * @brief Smallest distance between two points
+     *
+     * @param pts Row-major points
+     * @param dim Coordinates per point
+     * @param opts Parameters
+     * @return double
+     */
+    auto min_distance(span<const double> pts, size_t dim, const QualityOptions& opts) -> double {
+        assert(pts.size() % dim == 0 && pts.size() >= 2 * dim);
+        return min_distance_grid(CellGrid(pts, dim), dim, opts.threads);
+    }
+
+    /**
+     * @brief Covering radius, estimated over random probe points
+     *
+     * @param pts Row-major points on the unit sphere
+     * @param dim Coordinates per point
+     * @param opts Parameters
+     * @return double
+     */
+    auto covering_radius(span<const double> pts, size_t dim, const QualityOptions& opts)
+        -> double {
+        assert(pts.size() % dim == 0 && !pts.empty() && opts.n_probes > 0);
+        return covering_radius_grid(CellGrid(pts, dim), dim, opts);
+    }
+
+    /**
+     * @brief All metrics at once
+     *
+     * @param pts Row-major points on the unit sphere
+     * @param dim Coordinates per point
+     * @param opts Parameters
+     * @return QualityReport
+     */
+    auto measure_quality(span<const double> pts, size_t dim, const QualityOptions& opts)
+        -> QualityReport {
+        assert(pts.size() % dim == 0 && pts.size() >= 2 * dim);
+        const auto n = pts.size() / dim;
+        const auto soa = to_soa(pts, dim);
+        const auto grid = CellGrid(pts, dim);
+        return QualityReport{
+            cap_discrepancy_soa(soa, n, dim, opts),
+            riesz_energy_soa(soa, n, dim, opts),
+            min_distance_grid(grid, dim, opts.threads),
+            covering_radius_grid(grid, dim, opts),
+        };
+    }
+}  // namespace lds2
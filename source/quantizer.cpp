@@ -0,0 +1,291 @@
+#include <algorithm>               // for max
+#include <cassert>                 // for assert
+#include <cmath>                   // for sqrt
+#include <cstddef>                 // for size_t
+#include <limits>                  // for numeric_limits
+#include <span>                    // for span
+#include <sphere_n/quantizer.hpp>  // for SphereQuantizer
+#include <vector>                  // for vector
+
+using std::span;
+
+/** @brief Marks a missing child */
+static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+/** @brief Slack added to every cap radius, so rounding never excludes a codeword */
+static constexpr double CAP_SLACK = 1e-12;
+
+/**
+ * @brief Dot product of two vectors of length n
+ */
+static auto dot(const double* x, const double* y, size_t n) -> double {
+    auto res = 0.0;
+    for (auto d = size_t{0}; d != n; ++d) {
+        res += x[d] * y[d];
+    }
+    return res;
+}
+
+namespace lds2 {
+    static constexpr size_t L = SphereQuantizer::LEAF_SIZE;
+
+    /**
+     * @brief Construct an empty quantizer
+     *
+     * @param dim Coordinates per codeword
+     */
+    SphereQuantizer::SphereQuantizer(size_t dim) : n_dim{dim} { assert(dim >= 2); }
+
+    /**
+     * @brief Create a leaf node on an existing leaf block
+     *
+     * @param center Unit center of the cap
+     * @param leaf Leaf block
+     * @return size_t Index of the new node
+     */
+    auto SphereQuantizer::new_node(span<const double> center, size_t leaf) -> size_t {
+        const auto offset = this->centers.size();
+        this->centers.insert(this->centers.end(), center.begin(), center.end());
+        this->nodes.push_back(Node{offset, 1.0, 0.0, {NONE, NONE}, leaf});
+        return this->nodes.size() - 1;
+    }
+
+    /**
+     * @brief Create a leaf node with a new, empty leaf block
+     *
+     * @param center Unit center of the cap
+     * @return size_t Index of the new node
+     */
+    auto SphereQuantizer::new_leaf(span<const double> center) -> size_t {
+        const auto leaf = this->leaf_len.size();
+        this->leaf_pts.resize(this->leaf_pts.size() + L * this->n_dim, 0.0);
+        this->leaf_ids.resize(this->leaf_ids.size() + L, NONE);
+        this->leaf_len.push_back(0);
+        return this->new_node(center, leaf);
+    }
+
+    /**
+     * @brief Widen the cap of a node to cover codeword x
+     *
+     * @param node Index of the node
+     * @param x The codeword
+     */
+    auto SphereQuantizer::widen(size_t node, const double* x) -> void {
+        auto& nd = this->nodes[node];
+        const auto cos_t = dot(x, &this->centers[nd.center], this->n_dim) - CAP_SLACK;
+        if (cos_t < nd.cos_r) {
+            nd.cos_r = std::max(cos_t, -1.0);
+            nd.sin_r = std::sqrt(std::max(0.0, 1.0 - nd.cos_r * nd.cos_r));
+        }
+    }
+
+    /**
+     * @brief Store codeword `id` in a leaf with room for it
+     *
+     * @param node Index of the leaf node
+     * @param id Index into the codebook
+     */
+    auto SphereQuantizer::append(size_t node, size_t id) -> void {
+        const auto dim = this->n_dim;
+        const auto* x = &this->codebook[id * dim];
+        this->widen(node, x);
+        const auto leaf = this->nodes[node].leaf;
+        const auto pos = this->leaf_len[leaf]++;
+        auto* blk = &this->leaf_pts[leaf * L * dim];
+        for (auto d = size_t{0}; d != dim; ++d) {
+            blk[d * L + pos] = x[d];
+        }
+        this->leaf_ids[leaf * L + pos] = id;
+    }
+
+    /**
+     * @brief Append codewords
+     *
+     * @param pts Row-major unit codewords
+     */
+    auto SphereQuantizer::add(span<const double> pts) -> void {
+        assert(pts.size() % this->n_dim == 0);
+        const auto first = this->size();
+        this->codebook.insert(this->codebook.end(), pts.begin(), pts.end());
+        for (auto id = first; id != this->size(); ++id) {
+            this->insert(id);
+        }
+    }
+
+    /**
+     * @brief Insert codeword `id` along the path of nearest child centers
+     *
+     * @param id Index into the codebook
+     */
+    auto SphereQuantizer::insert(size_t id) -> void {
+        const auto dim = this->n_dim;
+        const auto* x = &this->codebook[id * dim];
+        if (this->nodes.empty()) {
+            this->new_leaf(this->codeword(id));
+        }
+        auto node = size_t{0};
+        while (this->nodes[node].child[0] != NONE) {
+            this->widen(node, x);
+            const auto& nd = this->nodes[node];
+            const auto d0 = dot(x, &this->centers[this->nodes[nd.child[0]].center], dim);
+            const auto d1 = dot(x, &this->centers[this->nodes[nd.child[1]].center], dim);
+            node = (d1 > d0) ? nd.child[1] : nd.child[0];
+        }
+        if (this->leaf_len[this->nodes[node].leaf] == L) {
+            this->widen(node, x);
+            this->split(node);
+            const auto& nd = this->nodes[node];
+            const auto d0 = dot(x, &this->centers[this->nodes[nd.child[0]].center], dim);
+            const auto d1 = dot(x, &this->centers[this->nodes[nd.child[1]].center], dim);
+            node = (d1 > d0) ? nd.child[1] : nd.child[0];
+        }
+        this->append(node, id);
+    }
+
+    /**
+     * @brief Split a full leaf into two leaves around two far-apart pivots
+     *
+     * Pivot a is the codeword farthest from the leaf center and pivot b the
+     * one farthest from a; every codeword goes to the nearer pivot. The new
+     * caps are centered on the normalized means of their halves.
+     *
+     * @param node Index of the full leaf
+     */
+    auto SphereQuantizer::split(size_t node) -> void {
+        const auto dim = this->n_dim;
+        const auto leaf = this->nodes[node].leaf;
+        const auto* center = &this->centers[this->nodes[node].center];
+        std::vector<size_t> ids(&this->leaf_ids[leaf * L], &this->leaf_ids[leaf * L] + L);
+        auto point = [this, dim](size_t id) { return &this->codebook[id * dim]; };
+
+        auto a = size_t{0};
+        auto b = size_t{0};
+        for (auto l = size_t{1}; l != L; ++l) {
+            if (dot(point(ids[l]), center, dim) < dot(point(ids[a]), center, dim)) a = l;
+        }
+        for (auto l = size_t{1}; l != L; ++l) {
+            if (dot(point(ids[l]), point(ids[a]), dim) < dot(point(ids[b]), point(ids[a]), dim))
+                b = l;
+        }
+        bool side[L];
+        for (auto l = size_t{0}; l != L; ++l) {
+            side[l] = (a == b) ? l >= L / 2  // all codewords coincide
+                               : dot(point(ids[l]), point(ids[b]), dim)
+                                     > dot(point(ids[l]), point(ids[a]), dim);
+        }
+        side[a] = false;
+        if (a != b) side[b] = true;
+
+        size_t child[2];
+        for (auto s = 0U; s != 2U; ++s) {
+            std::vector<double> mean(dim, 0.0);
+            for (auto l = size_t{0}; l != L; ++l) {
+                if (side[l] != (s == 1)) continue;
+                for (auto d = size_t{0}; d != dim; ++d) {
+                    mean[d] += point(ids[l])[d];
+                }
+            }
+            const auto norm = std::sqrt(dot(mean.data(), mean.data(), dim));
+            for (auto d = size_t{0}; d != dim; ++d) {
+                mean[d] = (norm > 1e-9) ? mean[d] / norm : point(ids[s == 0 ? a : b])[d];
+            }
+            // the first child takes over the block of the split leaf
+            child[s] = (s == 0) ? this->new_node(mean, leaf) : this->new_leaf(mean);
+        }
+        this->leaf_len[leaf] = 0;
+        this->nodes[node].child[0] = child[0];
+        this->nodes[node].child[1] = child[1];
+        this->nodes[node].leaf = NONE;
+        for (auto l = size_t{0}; l != L; ++l) {
+            this->append(child[side[l] ? 1 : 0], ids[l]);
+        }
+    }
+
+    /**
+     * @brief Branch-and-bound search below `node`
+     *
+     * @param q Unit query
+     * @param node Node to search
+     * @param best Largest <q, x> found so far
+     * @param best_id Its codeword index
+     */
+    auto SphereQuantizer::search(const double* q, size_t node, double& best,
+                                 size_t& best_id) const -> void {
+        const auto dim = this->n_dim;
+        const auto& nd = this->nodes[node];
+        if (nd.child[0] == NONE) {
+            // fixed trip count over the whole block, so the loop vectorizes
+            double acc[L] = {};
+            const auto* blk = &this->leaf_pts[nd.leaf * L * dim];
+            for (auto d = size_t{0}; d != dim; ++d) {
+                const auto qd = q[d];
+                for (auto l = size_t{0}; l != L; ++l) {
+                    acc[l] += blk[d * L + l] * qd;
+                }
+            }
+            for (auto l = size_t{0}; l != this->leaf_len[nd.leaf]; ++l) {
+                if (acc[l] > best) {
+                    best = acc[l];
+                    best_id = this->leaf_ids[nd.leaf * L + l];
+                }
+            }
+            return;
+        }
+        // upper bound of <q, x> over the cap of a child: cos(max(0, θ - ρ))
+        auto bound = [this, q, dim](size_t child) {
+            const auto& cn = this->nodes[child];
+            const auto cos_t = dot(q, &this->centers[cn.center], dim);
+            if (cos_t >= cn.cos_r) return 1.0;
+            const auto sin_t = std::sqrt(std::max(0.0, 1.0 - cos_t * cos_t));
+            return cos_t * cn.cos_r + sin_t * cn.sin_r;
+        };
+        const auto b0 = bound(nd.child[0]);
+        const auto b1 = bound(nd.child[1]);
+        const auto first = (b1 > b0) ? 1U : 0U;
+        const double bounds[2] = {b0, b1};
+        for (const auto s : {first, 1U - first}) {
+            if (bounds[s] > best) this->search(q, nd.child[s], best, best_id);
+        }
+    }
+
+    /**
+     * @brief Index of the codeword nearest to q
+     *
+     * @param q Query vector
+     * @return size_t
+     */
+    auto SphereQuantizer::nearest(span<const double> q) const -> size_t {
+        assert(q.size() == this->n_dim);
+        if (this->nodes.empty()) return this->size();
+        double qn[64];
+        std::vector<double> heap;
+        auto* u = qn;
+        if (this->n_dim > 64) {
+            heap.resize(this->n_dim);
+            u = heap.data();
+        }
+        const auto norm = std::sqrt(dot(q.data(), q.data(), this->n_dim));
+        const auto inv = (norm > 0.0) ? 1.0 / norm : 1.0;
+        for (auto d = size_t{0}; d != this->n_dim; ++d) {
+            u[d] = q[d] * inv;
+        }
+        auto best = -std::numeric_limits<double>::infinity();
+        auto best_id = size_t{0};
+        this->search(u, 0, best, best_id);
+        return best_id;
+    }
+
+    /**
+     * @brief Indices of the codewords nearest to a batch of queries
+     *
+     * @param queries Row-major query vectors
+     * @param res One index per query
+     */
+    auto SphereQuantizer::nearest_batch(span<const double> queries, span<size_t> res) const
+        -> void {
+        assert(queries.size() == res.size() * this->n_dim);
+        for (auto i = size_t{0}; i != res.size(); ++i) {
+            res[i] = this->nearest(queries.subspan(i * this->n_dim, this->n_dim));
+        }
+    }
+}  // namespace lds2
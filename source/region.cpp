@@ -0,0 +1,161 @@
+#include <algorithm>              // for min
+#include <cassert>                // for assert
+#include <cmath>                  // for cos, sqrt
+#include <cstddef>                // for size_t
+#include <numbers>                // for pi
+#include <span>                   // for span
+#include <sphere_n/region.hpp>    // for RegionN, Mapping
+#include <sphere_n/sphere_n.hpp>  // for map_points, tp_cdf
+#include <sphere_n/stats.hpp>     // for SPHERE_N_TRACE_SCOPE
+#include <vector>                 // for vector
+
+/** @brief Points per block of the batch path */
+static constexpr size_t REGION_BLOCK = 64;
+
+/** @brief Largest number of sequence values of the single-point path without allocation */
+static constexpr size_t MAX_STACK_DIM = 64;
+
+namespace lds2 {
+    /**
+     * @brief Construct a generator on a band
+     *
+     * @param base Bases of the sequence values
+     * @param axis Axis of the band
+     * @param theta_min Smallest angle to the axis
+     * @param theta_max Largest angle to the axis
+     * @param mapping Mapping of the sequence values
+     */
+    RegionN::RegionN(span<const unsigned long> base, span<const double> axis, double theta_min,
+                     double theta_max, Mapping mapping)
+        : halton{base}, mapping{mapping}, theta_min{theta_min}, theta_max{theta_max} {
+        const auto m = base.size();
+        assert(m >= 2 && axis.size() == m + 1);
+        assert(0.0 <= theta_min && theta_min <= theta_max && theta_max <= std::numbers::pi);
+
+        auto norm2 = 0.0;
+        for (const auto a : axis) {
+            norm2 += a * a;
+        }
+        assert(norm2 > 0.0);
+        const auto inv = 1.0 / std::sqrt(norm2);
+        // v = e_m - axis; the reflection along v swaps e_m and axis
+        this->refl.resize(m + 1);
+        auto vv = 0.0;
+        for (auto d = size_t{0}; d != m + 1; ++d) {
+            this->refl[d] = ((d == m) ? 1.0 : 0.0) - axis[d] * inv;
+            vv += this->refl[d] * this->refl[d];
+        }
+        if (vv > 0.0) {
+            this->refl_scale = 2.0 / vv;
+        } else {
+            this->refl.clear();
+            this->refl_scale = 0.0;
+        }
+        this->update_interval();
+    }
+
+    /**
+     * @brief Remapped interval of the first sequence value for the band limits
+     *
+     * For `Mapping::sphere` the angle to the pole grows with u0 through the
+     * normalized Tp CDF; for `Mapping::cylind` cos(angle) = 2 u0 - 1, so u0
+     * shrinks as the angle grows. Full-sphere limits leave u0 unchanged.
+     */
+    auto RegionN::update_interval() -> void {
+        const auto m = this->halton.size();
+        auto lo = 0.0;
+        auto hi = 1.0;
+        if (this->mapping == Mapping::sphere && m >= 3) {
+            if (this->theta_min > 0.0) lo = tp_cdf(m - 1, this->theta_min, this->inversion);
+            if (this->theta_max < std::numbers::pi) {
+                hi = tp_cdf(m - 1, this->theta_max, this->inversion);
+            }
+        } else {
+            // S^2 of `Mapping::sphere` uses the same z = 2 u0 - 1 as `CylindN`
+            lo = 0.5 * (1.0 + std::cos(this->theta_max));
+            hi = 0.5 * (1.0 + std::cos(this->theta_min));
+        }
+        this->u_lo = lo;
+        this->u_span = std::max(hi - lo, 0.0);
+    }
+
+    /**
+     * @brief Select the Tp inversion method of `Mapping::sphere`
+     *
+     * @param mode Inversion method
+     */
+    auto RegionN::set_inversion(Inversion mode) -> void {
+        this->inversion = mode;
+        this->update_interval();
+    }
+
+    /**
+     * @brief Map a block of sequence values into the band
+     *
+     * @param u Row-major sequence values, m per point; overwritten
+     * @param res Row-major output points, m + 1 values each
+     */
+    auto RegionN::map_block(span<double> u, span<double> res) const -> void {
+        const auto m = this->halton.size();
+        const auto stride = m + 1;
+        const auto nb = res.size() / stride;
+        for (auto r = size_t{0}; r != nb; ++r) {
+            u[r * m] = this->u_lo + u[r * m] * this->u_span;
+        }
+        map_points(this->mapping, m, u, res, this->inversion, this->accuracy);
+        if (this->refl.empty()) return;
+        const auto* v = this->refl.data();
+        for (auto r = size_t{0}; r != nb; ++r) {
+            auto* x = &res[r * stride];
+            auto dot = 0.0;
+            for (auto d = size_t{0}; d != stride; ++d) {
+                dot += v[d] * x[d];
+            }
+            dot *= this->refl_scale;
+            for (auto d = size_t{0}; d != stride; ++d) {
+                x[d] -= dot * v[d];
+            }
+        }
+    }
+
+    /**
+     * @brief Next point into a buffer
+     *
+     * @param res Output buffer of `size()` values
+     */
+    auto RegionN::pop_into(span<double> res) -> void {
+        const auto m = this->halton.size();
+        assert(res.size() == m + 1);
+        double stack[MAX_STACK_DIM];
+        vector<double> heap;
+        auto u = span<double>(stack, std::min(m, MAX_STACK_DIM));
+        if (m > MAX_STACK_DIM) {
+            heap.resize(m);
+            u = span<double>(heap);
+        }
+        this->halton.pop_into(u);
+        this->map_block(u, res);
+    }
+
+    /**
+     * @brief Next points
+     *
+     * Each block of sequence values is drawn in one `HaltonN::pop_batch()`
+     * call and mapped in one `map_points()` call.
+     *
+     * @param res Row-major output points
+     */
+    auto RegionN::pop_batch(span<double> res) -> void {
+        SPHERE_N_TRACE_SCOPE("lds2::RegionN::pop_batch");
+        const auto m = this->halton.size();
+        const auto count = res.size() / (m + 1);
+        assert(res.size() == count * (m + 1));
+        vector<double> u(REGION_BLOCK * m);
+        for (auto r0 = size_t{0}; r0 < count; r0 += REGION_BLOCK) {
+            const auto nb = std::min(REGION_BLOCK, count - r0);
+            const auto ub = span<double>(u).first(nb * m);
+            this->halton.pop_batch(ub);
+            this->map_block(ub, res.subspan(r0 * (m + 1), nb * (m + 1)));
+        }
+    }
+}  // namespace lds2
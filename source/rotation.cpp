@@ -0,0 +1,155 @@
+#include <algorithm>              // for min
+#include <array>                  // for array
+#include <cassert>                // for assert
+#include <cstddef>                // for size_t
+#include <span>                   // for span
+#include <sphere_n/rotation.hpp>  // for Rotation3, quat_to_matrix
+#include <sphere_n/sphere_n.hpp>  // for map_sphere_n
+#include <sphere_n/stats.hpp>     // for SPHERE_N_TRACE_SCOPE
+
+/** @brief Rotations per block of the batch paths */
+static constexpr size_t ROT_BLOCK = 64;
+
+/**
+ * @brief Convert nb <= ROT_BLOCK quaternions to matrices
+ *
+ * The quaternions are transposed into coordinate-major arrays, the nine
+ * entries are computed by unit-stride loops and transposed back. Called
+ * with nb == ROT_BLOCK, the loops have a fixed trip count and vectorize.
+ *
+ * @param q Row-major quaternions
+ * @param m Row-major matrices
+ * @param nb Number of rotations
+ */
+static inline void quat_block(const double* q, double* m, size_t nb) {
+    double x[ROT_BLOCK];
+    double y[ROT_BLOCK];
+    double z[ROT_BLOCK];
+    double w[ROT_BLOCK];
+    for (auto r = size_t{0}; r != nb; ++r) {
+        x[r] = q[4 * r];
+        y[r] = q[4 * r + 1];
+        z[r] = q[4 * r + 2];
+        w[r] = q[4 * r + 3];
+    }
+    double e[9][ROT_BLOCK];
+    for (auto r = size_t{0}; r != nb; ++r) {
+        const auto xx = x[r] * x[r];
+        const auto yy = y[r] * y[r];
+        const auto zz = z[r] * z[r];
+        const auto xy = x[r] * y[r];
+        const auto xz = x[r] * z[r];
+        const auto yz = y[r] * z[r];
+        const auto xw = x[r] * w[r];
+        const auto yw = y[r] * w[r];
+        const auto zw = z[r] * w[r];
+        e[0][r] = 1.0 - 2.0 * (yy + zz);
+        e[1][r] = 2.0 * (xy - zw);
+        e[2][r] = 2.0 * (xz + yw);
+        e[3][r] = 2.0 * (xy + zw);
+        e[4][r] = 1.0 - 2.0 * (xx + zz);
+        e[5][r] = 2.0 * (yz - xw);
+        e[6][r] = 2.0 * (xz - yw);
+        e[7][r] = 2.0 * (yz + xw);
+        e[8][r] = 1.0 - 2.0 * (xx + yy);
+    }
+    for (auto r = size_t{0}; r != nb; ++r) {
+        for (auto j = 0U; j != 9U; ++j) {
+            m[9 * r + j] = e[j][r];
+        }
+    }
+}
+
+namespace lds2 {
+    /**
+     * @brief Convert unit quaternions to rotation matrices
+     *
+     * @param quat Row-major quaternions [x, y, z, w]
+     * @param mat Row-major 3x3 matrices
+     */
+    auto quat_to_matrix(span<const double> quat, span<double> mat) -> void {
+        const auto count = quat.size() / 4;
+        assert(quat.size() == count * 4 && mat.size() == count * 9);
+        auto r0 = size_t{0};
+        for (; r0 + ROT_BLOCK <= count; r0 += ROT_BLOCK) {
+            quat_block(&quat[r0 * 4], &mat[r0 * 9], ROT_BLOCK);
+        }
+        if (r0 != count) {
+            quat_block(&quat[r0 * 4], &mat[r0 * 9], count - r0);
+        }
+    }
+
+    /**
+     * @brief Map sequence values to quaternions with w >= 0
+     *
+     * @param u Row-major sequence values, 3 per rotation; overwritten
+     * @param res Row-major output quaternions
+     */
+    auto Rotation3::map_block(span<double> u, span<double> res) const -> void {
+        const auto nb = res.size() / 4;
+        if (this->antipodal == Antipodal::hemisphere) {
+            for (auto r = size_t{0}; r != nb; ++r) {
+                u[r * 3] *= 0.5;  // xi in [0, π/2], so w = cos(xi) >= 0
+            }
+        }
+        map_sphere_n(3, u, res, this->inversion, this->accuracy);
+        if (this->antipodal == Antipodal::fold) {
+            for (auto r = size_t{0}; r != nb; ++r) {
+                const auto sign = (res[r * 4 + 3] < 0.0) ? -1.0 : 1.0;
+                for (auto j = 0U; j != 4U; ++j) {
+                    res[r * 4 + j] *= sign;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Next rotation as a quaternion
+     *
+     * @param res Output quaternion [x, y, z, w]
+     */
+    auto Rotation3::pop_into(span<double> res) -> void {
+        assert(res.size() == 4);
+        std::array<double, 3> u;
+        this->halton.pop_into(u);
+        this->map_block(u, res);
+    }
+
+    /**
+     * @brief Next rotations as quaternions
+     *
+     * Each block of sequence values is drawn in one `HaltonN::pop_batch()`
+     * call and mapped in one `map_sphere_n()` call.
+     *
+     * @param res Row-major output quaternions
+     */
+    auto Rotation3::pop_batch(span<double> res) -> void {
+        SPHERE_N_TRACE_SCOPE("lds2::Rotation3::pop_batch");
+        const auto count = res.size() / 4;
+        assert(res.size() == count * 4);
+        std::array<double, ROT_BLOCK * 3> u;
+        for (auto r0 = size_t{0}; r0 < count; r0 += ROT_BLOCK) {
+            const auto nb = std::min(ROT_BLOCK, count - r0);
+            const auto ub = span<double>(u).first(nb * 3);
+            this->halton.pop_batch(ub);
+            this->map_block(ub, res.subspan(r0 * 4, nb * 4));
+        }
+    }
+
+    /**
+     * @brief Next rotations as matrices
+     *
+     * @param res Row-major output matrices
+     */
+    auto Rotation3::pop_batch_matrix(span<double> res) -> void {
+        const auto count = res.size() / 9;
+        assert(res.size() == count * 9);
+        std::array<double, ROT_BLOCK * 4> q;
+        for (auto r0 = size_t{0}; r0 < count; r0 += ROT_BLOCK) {
+            const auto nb = std::min(ROT_BLOCK, count - r0);
+            const auto qb = span<double>(q).first(nb * 4);
+            this->pop_batch(qb);
+            quat_to_matrix(qb, res.subspan(r0 * 9, nb * 9));
+        }
+    }
+}  // namespace lds2
@@ -0,0 +1,160 @@
+#include <algorithm>                     // for fill, max
+#include <cassert>                       // for assert
+#include <cstdint>                       // for uint64_t
+#include <numeric>                       // for gcd
+#include <random>                        // for mt19937_64
+#include <span>                          // for span
+#include <sphere_n/cylind_n.hpp>         // for map_cylind_n
+#include <sphere_n/radical_inverse.hpp>  // for digit_expand, radical_inverse
+#include <sphere_n/rqmc.hpp>             // for RandomizedVdCorput, RandomizedSphereN
+#include <sphere_n/sphere_n.hpp>         // for map_sphere_n
+#include <vector>                        // for vector
+
+/**
+ * @brief Number of base-b digits needed to resolve a double in [0, 1)
+ *
+ * @param base The base
+ * @return size_t Smallest J with b^J >= 2^53
+ */
+static auto digits_for_double(unsigned long base) -> size_t {
+    constexpr auto TWO_POW_53 = 9007199254740992.0;
+    size_t res = 0;
+    for (auto scale = 1.0; scale < TWO_POW_53; scale *= static_cast<double>(base)) {
+        ++res;
+    }
+    return res;
+}
+
+namespace lds2 {
+    /**
+     * @brief Construct the randomized replicates
+     *
+     * The parameters are drawn in a fixed order (base, digit, replicate)
+     * from the raw `std::mt19937_64` output, which is fully specified by the
+     * standard, so the same seed gives the same replicates everywhere.
+     *
+     * @param base Bases of the Van der Corput sequences
+     * @param replicates Number of independent replicates R
+     * @param seed Seed of the randomization
+     * @param kind Randomization method
+     */
+    RandomizedVdCorput::RandomizedVdCorput(span<const unsigned long> base, size_t replicates,
+                                           std::uint64_t seed, Randomization kind)
+        : base(base.begin(), base.end()), n_rep{replicates}, kind{kind}, acc(replicates) {
+        std::mt19937_64 rng(seed);
+        size_t max_digits = 0;
+        for (const auto b : this->base) {
+            assert(b >= 2);
+            const auto nd = digits_for_double(b);
+            this->n_digits.push_back(nd);
+            this->offset.push_back(this->mult.size());
+            max_digits = std::max(max_digits, nd);
+            if (kind == Randomization::random_shift) {
+                for (auto r = 0U; r != replicates; ++r) {
+                    this->shift.push_back(static_cast<double>(rng() >> 11U) * 0x1.0p-53);
+                }
+                continue;
+            }
+            for (auto j = 0U; j != nd * replicates; ++j) {
+                auto a = 1 + rng() % (b - 1);
+                while (std::gcd(a, std::uint64_t{b}) != 1) {
+                    a = 1 + rng() % (b - 1);
+                }
+                this->mult.push_back(a);
+                this->add.push_back(rng() % b);
+            }
+        }
+        this->digits.resize(max_digits);
+    }
+
+    /**
+     * @brief Randomized values for sequence index k
+     *
+     * The digit loop runs from the least significant position outwards
+     * (Horner's scheme), with the replicates in the inner loop so that it
+     * vectorizes across replicates.
+     *
+     * @param k Index into the sequence
+     * @param u Row-major output values
+     */
+    auto RandomizedVdCorput::values(unsigned long k, span<double> u) -> void {
+        const auto m = this->base.size();
+        assert(u.size() == this->n_rep * m);
+        for (auto d = 0U; d != m; ++d) {
+            const auto b = this->base[d];
+            if (this->kind == Randomization::random_shift) {
+                const auto v = radical_inverse(k, b);
+                for (auto r = 0U; r != this->n_rep; ++r) {
+                    const auto w = v + this->shift[d * this->n_rep + r];
+                    u[r * m + d] = (w >= 1.0) ? w - 1.0 : w;
+                }
+                continue;
+            }
+            const auto nd = this->n_digits[d];
+            const auto dig = span<unsigned long>(this->digits).first(nd);
+            digit_expand(k, b, dig);
+            const auto fb = static_cast<double>(b);
+            std::fill(this->acc.begin(), this->acc.end(), 0.0);
+            for (auto j = nd; j-- != 0;) {
+                const auto* a = &this->mult[this->offset[d] + j * this->n_rep];
+                const auto* s = &this->add[this->offset[d] + j * this->n_rep];
+                const std::uint64_t dj = dig[j];
+                for (auto r = 0U; r != this->n_rep; ++r) {
+                    const auto pj = (a[r] * dj + s[r]) % b;
+                    this->acc[r] = (static_cast<double>(pj) + this->acc[r]) / fb;
+                }
+            }
+            for (auto r = 0U; r != this->n_rep; ++r) {
+                u[r * m + d] = this->acc[r];
+            }
+        }
+    }
+
+    /**
+     * @brief Construct a new RandomizedSphereN object
+     *
+     * @param base Bases as for `SphereN`
+     * @param replicates Number of independent replicates R
+     * @param seed Seed of the randomization
+     * @param kind Randomization method
+     */
+    RandomizedSphereN::RandomizedSphereN(span<const unsigned long> base, size_t replicates,
+                                         std::uint64_t seed, Randomization kind)
+        : m{base.size()}, rvdc{base, replicates, seed, kind}, u(replicates * base.size()) {
+        assert(m >= 3);
+    }
+
+    /**
+     * @brief Generate the next point of every replicate
+     *
+     * @param res Row-major output coordinates
+     */
+    auto RandomizedSphereN::pop_batch(span<double> res) -> void {
+        this->rvdc.values(++this->count, this->u);
+        map_sphere_n(this->m, this->u, res);
+    }
+
+    /**
+     * @brief Construct a new RandomizedCylindN object
+     *
+     * @param base Bases as for `CylindN`
+     * @param replicates Number of independent replicates R
+     * @param seed Seed of the randomization
+     * @param kind Randomization method
+     */
+    RandomizedCylindN::RandomizedCylindN(span<const unsigned long> base, size_t replicates,
+                                         std::uint64_t seed, Randomization kind)
+        : m{base.size()}, rvdc{base, replicates, seed, kind}, u(replicates * base.size()) {
+        assert(m >= 2);
+    }
+
+    /**
+     * @brief Generate the next point of every replicate
+     *
+     * @param res Row-major output coordinates
+     */
+    auto RandomizedCylindN::pop_batch(span<double> res) -> void {
+        this->rvdc.values(++this->count, this->u);
+        map_cylind_n(this->m, this->u, res);
+    }
+}  // namespace lds2
@@ -1,17 +1,30 @@
-#include <algorithm>
-#include <cassert>         // for assert
-#include <cmath>           // for cos, sin, sqrt
-#include <cstddef>         // for size_t
-#include <ldsgen/lds.hpp>  // for vdcorput, sphere
-#include <memory>          // for unique_ptr, make_unique
+#include <algorithm>        // for clamp, min, upper_bound
+#include <cassert>          // for assert
+#include <cmath>            // for atan2, cos, sin, sqrt, cbrt, pow
+#include <cstddef>          // for size_t
+#include <ldsgen/lds.hpp>   // for vdcorput, sphere
+#include <limits>           // for numeric_limits
+#include <memory>           // for unique_ptr
+#include <memory_resource>  // for memory_resource
 #include <mutex>
 #include <numbers>
 #include <span>                   // for span
+#include <sphere_n/cylind_n.hpp>  // for map_cylind_n
+#include <sphere_n/sincos.hpp>    // for sin_cos, Accuracy, SPHERE_N_ALWAYS_INLINE
 #include <sphere_n/sphere_n.hpp>  // for sphere_n, cylin_n, cylin_2
+#include <sphere_n/stats.hpp>     // for SPHERE_N_STATS_ADD, SPHERE_N_STATS_TIME
+#include <type_traits>            // for integral_constant, is_integral_v
 #include <unordered_map>          // for unordered_map
+#include <utility>                // for index_sequence, make_index_sequence
 #include <variant>                // for visit, variant
 #include <vector>                 // for vector
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#    define SPHERE_N_HAS_AVX2_KERNELS 1
+#else
+#    define SPHERE_N_HAS_AVX2_KERNELS 0
+#endif
+
 // Mathematical constants
 /** @brief π constant with high precision */
 static constexpr double PI = std::numbers::pi;
@@ -40,6 +53,7 @@ class Globals {
     std::mutex cacheMutex;           ///< Mutex for thread-safe cache access
     std::unordered_map<size_t, std::vector<double>> cacheOdd;   ///< Cache for odd n values
     std::unordered_map<size_t, std::vector<double>> cacheEven;  ///< Cache for even n values
+    std::unordered_map<size_t, std::vector<double>> cacheCoarse;  ///< Coarse Tp tables
 
   public:
     /**
@@ -61,6 +75,17 @@ class Globals {
      */
     const std::vector<double>& getTp(size_t n);
 
+    /**
+     * @brief Get the coarse Tp table for dimension n with caching
+     *
+     * N_COARSE exact values of Tp(n) on a uniform grid over [0, π], used as
+     * the starting guess of the Newton-refined inversion.
+     *
+     * @param n Dimension parameter
+     * @return const std::vector<double>& Coarse Tp values for dimension n
+     */
+    const std::vector<double>& getCoarseTp(size_t n);
+
     /**
      * @brief Initialize global vectors with trigonometric values
      *
@@ -94,12 +119,15 @@ class Globals {
         // std::lock_guard<std::mutex> lock(this->cacheMutex);
         auto& cache = ::cacheOdd;
         if (cache.contains(n)) return cache[n];
+        SPHERE_N_STATS_ADD(tp_builds, 1);
+        SPHERE_N_TRACE_SCOPE("lds2::Tp build");
 
         std::vector<double> result;
         if (n == 1) {
             result = NEG_COSINE;
         } else {
             std::vector<double> tpMinus2 = getTpOdd(n - 2);
+            SPHERE_N_STATS_TIME(tp_build_ns);
             result.resize(lds2::N_POINTS);
             for (auto i = 0U; i < lds2::N_POINTS; ++i) {
                 result[i] = (static_cast<double>(n - 1) * tpMinus2[i]
@@ -125,12 +153,15 @@ class Globals {
         // std::lock_guard<std::mutex> lock(this->cacheMutex);
         auto& cache = ::cacheEven;
         if (cache.contains(n)) return cache[n];
+        SPHERE_N_STATS_ADD(tp_builds, 1);
+        SPHERE_N_TRACE_SCOPE("lds2::Tp build");
 
         std::vector<double> result;
         if (n == 0) {
             result = X;
         } else {
             std::vector<double> tpMinus2 = this->getTpEven(n - 2);
+            SPHERE_N_STATS_TIME(tp_build_ns);
             result.resize(lds2::N_POINTS);
             for (auto i = 0U; i < lds2::N_POINTS; ++i) {
                 result[i] = (static_cast<double>(n - 1) * tpMinus2[i]
@@ -153,10 +184,41 @@ class Globals {
  * @return const std::vector<double>& Tp values for dimension n
  */
 const std::vector<double>& Globals::getTp(size_t n) {
-    std::scoped_lock lock(this->cacheMutex);
+    std::unique_lock lock(this->cacheMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        SPHERE_N_STATS_ADD(lock_contended, 1);
+        SPHERE_N_STATS_TIME(lock_wait_ns);
+        SPHERE_N_TRACE_SCOPE("lds2::cacheMutex wait");
+        lock.lock();
+    }
+#ifdef SPHERE_N_STATS
+    if (((n % 2 == 0) ? ::cacheEven : ::cacheOdd).contains(n)) {
+        SPHERE_N_STATS_ADD(tp_cache_hits, 1);
+    } else {
+        SPHERE_N_STATS_ADD(tp_cache_misses, 1);
+    }
+#endif
     return (n % 2 == 0) ? this->getTpEven(n) : this->getTpOdd(n);
 }
 
+/**
+ * @brief Get the coarse Tp table for dimension n with caching
+ *
+ * @param n Dimension parameter
+ * @return const std::vector<double>& Coarse Tp values for dimension n
+ */
+const std::vector<double>& Globals::getCoarseTp(size_t n) {
+    std::scoped_lock lock(this->cacheMutex);
+    auto& coarse = this->cacheCoarse[n];
+    if (coarse.empty()) {
+        coarse.resize(lds2::N_COARSE);
+        for (auto i = 0U; i < lds2::N_COARSE; ++i) {
+            coarse[i] = lds2::tp_value(n, i * PI / static_cast<double>(lds2::N_COARSE - 1));
+        }
+    }
+    return coarse;
+}
+
 /** @brief Global singleton instance of the Globals class */
 static Globals GL{};
 
@@ -171,7 +233,10 @@ static Globals GL{};
  * @param val The value to interpolate at
  * @return double Interpolated value
  */
-static double interp(const std::vector<double>& x, const std::vector<double>& X, double val) {
+SPHERE_N_ALWAYS_INLINE static inline double interp(const std::vector<double>& x,
+                                                   const std::vector<double>& X, double val) {
+    SPHERE_N_STATS_ADD(interp_calls, 1);
+    SPHERE_N_STATS_TIME(interp_ns);
     // A simple linear interpolation for demonstration purposes
     auto pos = std::ranges::upper_bound(X, val) - X.begin();
     auto len = std::distance(X.begin(), X.end());
@@ -182,6 +247,220 @@ static double interp(const std::vector<double>& x, const std::vector<double>& X,
     return x[spos - 1] + fraction * (x[spos] - x[spos - 1]);
 }
 
+/**
+ * @brief Tp(n) at x, given sin(x) and cos(x)
+ *
+ * Evaluates the recursion Tp(n) = ((n-1) * Tp(n-2) - cos(x) * sin(x)^(n-1)) / n
+ * upwards from Tp(0) = x or Tp(1) = -cos(x), in O(n) flops.
+ *
+ * @param n Dimension parameter
+ * @param x The angle
+ * @param sinx sin(x)
+ * @param cosx cos(x)
+ * @param sinn Receives sin(x)^n, the derivative of Tp(n) at x
+ * @return double Tp(n) at x
+ */
+static double tp_value_sc(size_t n, double x, double sinx, double cosx, double& sinn) {
+    auto tp = (n % 2 == 0) ? x : -cosx;
+    auto spow = (n % 2 == 0) ? 1.0 : sinx;  // sin(x)^(k-2)
+    const auto sin2 = sinx * sinx;
+    for (auto k = (n % 2 == 0) ? size_t{2} : size_t{3}; k <= n; k += 2) {
+        tp = (static_cast<double>(k - 1) * tp - cosx * spow * sinx) / static_cast<double>(k);
+        spow *= sin2;
+    }
+    sinn = spow;
+    return tp;
+}
+
+/**
+ * @brief Refine x with Tp(n)(x) = t by safeguarded Halley iterations
+ *
+ * Uses the closed-form derivatives Tp'(n) = sin^n(x) and
+ * Tp''(n) = n sin^(n-1)(x) cos(x). Tp is increasing, so every iterate
+ * shrinks the bracket [lo, hi]; a Halley step leaving the bracket falls
+ * back to the Newton step, and that to bisection.
+ *
+ * @param n Dimension parameter
+ * @param t Target value
+ * @param x Initial guess inside [lo, hi]
+ * @param lo Lower end of a bracket of the root
+ * @param hi Upper end of a bracket of the root
+ * @return double The refined root
+ */
+SPHERE_N_ALWAYS_INLINE static inline double tp_refine(size_t n, double t, double x, double lo,
+                                                      double hi) {
+    constexpr auto MAX_ITER = 40;
+    constexpr auto TOL = 4.0 * std::numeric_limits<double>::epsilon();
+    for (auto iter = 0; iter != MAX_ITER; ++iter) {
+        const auto sinx = sin(x);
+        const auto cosx = cos(x);
+        auto d1 = 0.0;
+        const auto f = tp_value_sc(n, x, sinx, cosx, d1) - t;
+        if (f == 0.0) return x;
+        (f > 0.0 ? hi : lo) = x;
+        const auto newton = f / d1;
+        // d2 / d1 = n cos(x) / sin(x)
+        auto xn = x - newton / (1.0 - 0.5 * newton * static_cast<double>(n) * cosx / sinx);
+        if (!(xn > lo && xn < hi)) xn = x - newton;              // also catches NaN and inf
+        if (!(xn > lo && xn < hi)) xn = 0.5 * (lo + hi);
+        if (std::abs(xn - x) <= TOL * (1.0 + x) || hi - lo <= TOL * (1.0 + hi)) return xn;
+        x = xn;
+    }
+    return x;
+}
+
+/**
+ * @brief Inverse of the normalized Tp CDF for one dimension
+ *
+ * Maps u in [0, 1] to the angle xi in [0, π] with
+ * (Tp(xi) - Tp(0)) / (Tp(π) - Tp(0)) = u. The tables are fetched once at
+ * construction, so one object can serve a whole batch of values.
+ */
+class TpInverse {
+    size_t n;
+    lds2::Inversion mode;
+    const std::vector<double>* table = nullptr;  ///< fine (interp) or coarse (newton) table
+    const std::vector<double>* grid = nullptr;   ///< angles of the fine table (interp)
+    double t0;                                   ///< Tp(0)
+    double dt;                                   ///< Tp(π) - Tp(0)
+
+    /**
+     * @brief Set t0 and dt from the table
+     */
+    void set_range() {
+        if (this->table != nullptr) {
+            this->t0 = this->table->front();
+            this->dt = this->table->back() - this->t0;
+        } else {
+            this->t0 = 0.0;
+            this->dt = HALF_PI;
+        }
+    }
+
+  public:
+    /**
+     * @brief Fetch the tables needed for dimension n
+     *
+     * @param n Dimension parameter
+     * @param mode Inversion method
+     */
+    TpInverse(size_t n, lds2::Inversion mode) : n{n}, mode{mode} {
+        if (mode == lds2::Inversion::interp) {
+            this->table = (n == 2) ? &GL.getF2() : &GL.getTp(n);
+            this->grid = &GL.getX();
+        } else if (n != 2) {
+            this->table = &GL.getCoarseTp(n);  // n == 2 needs no table
+        }
+        this->set_range();
+    }
+
+    /**
+     * @brief Interpolate in a copy of the fine table of dimension n
+     *
+     * @param n Dimension parameter
+     * @param grid Copy of the angle grid
+     * @param table Copy of the fine table of dimension n
+     */
+    TpInverse(size_t n, const std::vector<double>& grid, const std::vector<double>& table)
+        : n{n}, mode{lds2::Inversion::interp}, table{&table}, grid{&grid} {
+        this->set_range();
+    }
+
+    /**
+     * @brief Angle for the normalized value u
+     *
+     * @param u Value in [0, 1]
+     * @return double Angle in [0, π]
+     */
+    double operator()(double u) const {
+        if (this->mode == lds2::Inversion::interp) {
+            const auto ti = (this->n == 2) ? HALF_PI * u : this->t0 + this->dt * u;
+            return ::interp(*this->grid, *this->table, ti);
+        }
+        if (u <= 0.0) return 0.0;
+        if (u >= 1.0) return PI;
+        const auto t = this->t0 + this->dt * u;
+        if (this->table == nullptr) {
+            // n == 2: Tp(2)(x) = x^3 / 3 - x^5 / 15 + O(x^7), inverted as
+            // y + y^3 / 15 with y = cbrt(3 t), and Tp(2)(π - x) = π/2 - Tp(2)(x)
+            const auto guess = [](double t2) {
+                const auto y = std::cbrt(3.0 * t2);
+                return std::min(y + y * y * y / 15.0, HALF_PI);
+            };
+            if (u <= 0.5) return tp_refine(2, t, guess(t), 0.0, HALF_PI);
+            return tp_refine(2, t, PI - guess(HALF_PI - t), HALF_PI, PI);
+        }
+        // initial guess by linear interpolation in the coarse table
+        const auto& coarse = *this->table;
+        const auto step = PI / static_cast<double>(lds2::N_COARSE - 1);
+        auto pos = static_cast<size_t>(std::ranges::upper_bound(coarse, t) - coarse.begin());
+        pos = std::clamp(pos, size_t{1}, lds2::N_COARSE - 1);
+        const auto lo = static_cast<double>(pos - 1) * step;
+        const auto den = coarse[pos] - coarse[pos - 1];
+        const auto frac = (den > 0.0) ? std::clamp((t - coarse[pos - 1]) / den, 0.0, 1.0) : 0.5;
+        return tp_refine(this->n, t, lo + frac * step, lo, lo + step);
+    }
+};
+
+/**
+ * @brief Normalized Tp CDF for one dimension, the inverse of TpInverse
+ *
+ * Maps the angle xi in [0, π] back to u in [0, 1]. In interp mode the fine
+ * table is read forwards: its angles lie on a uniform grid, so the cell of
+ * xi is found by one multiplication instead of a search, and the linear
+ * interpolation exactly undoes the one of `TpInverse`. In newton mode Tp
+ * is evaluated exactly.
+ */
+class TpForward {
+    size_t n;
+    lds2::Inversion mode;
+    const std::vector<double>* table = nullptr;  ///< fine table (interp only)
+    double t0;                                   ///< Tp(0)
+    double scale;                                ///< 1 / (Tp(π) - Tp(0))
+
+  public:
+    /**
+     * @brief Fetch the tables needed for dimension n
+     *
+     * @param n Dimension parameter
+     * @param mode Inversion method
+     */
+    TpForward(size_t n, lds2::Inversion mode) : n{n}, mode{mode} {
+        if (mode == lds2::Inversion::interp) {
+            this->table = (n == 2) ? &GL.getF2() : &GL.getTp(n);
+        }
+        if (n == 2) {
+            this->t0 = 0.0;  // TpInverse scales by π/2 for n == 2 in both modes
+            this->scale = 1.0 / HALF_PI;
+        } else {
+            const auto& ends = (this->table != nullptr) ? *this->table : GL.getCoarseTp(n);
+            this->t0 = ends.front();
+            this->scale = 1.0 / (ends.back() - this->t0);
+        }
+    }
+
+    /**
+     * @brief Normalized value for the angle xi
+     *
+     * @param xi Angle in [0, π]
+     * @return double Value in [0, 1]
+     */
+    double operator()(double xi) const {
+        if (this->mode == lds2::Inversion::interp) {
+            const auto& tab = *this->table;
+            const auto last = static_cast<double>(tab.size() - 1);
+            const auto pos = std::clamp(xi * (last / PI), 0.0, last);
+            const auto i = std::min(static_cast<size_t>(pos), tab.size() - 2);
+            const auto frac = pos - static_cast<double>(i);
+            const auto t = tab[i] + frac * (tab[i + 1] - tab[i]);
+            return std::clamp((t - this->t0) * this->scale, 0.0, 1.0);
+        }
+        auto sinn = 0.0;
+        const auto t = tp_value_sc(this->n, xi, std::sin(xi), std::cos(xi), sinn);
+        return std::clamp((t - this->t0) * this->scale, 0.0, 1.0);
+    }
+};
+
 /**
  * @brief lds2 namespace for low discrepancy sequence generation
  *
@@ -211,7 +490,8 @@ namespace lds2 {
      * [sin(xi)*s0, sin(xi)*s1, sin(xi)*s2, cos(xi)]
      * where [s0, s1, s2] is a point on the 2-sphere and xi is interpolated.
      */
-    Sphere3::Sphere3(span<const unsigned long> base) : vdc{base[0]}, sphere2{base[1], base[2]} {}
+    Sphere3::Sphere3(span<const unsigned long> base)
+        : bases{base[0], base[1], base[2]}, vdc{base[0]}, sphere2{base[1], base[2]} {}
 
     /**
      * @brief Generate the next point on the 3-sphere
@@ -228,14 +508,50 @@ namespace lds2 {
      * 4. Transform to 3-sphere: [sin(xi)*s0, sin(xi)*s1, sin(xi)*s2, cos(xi)]
      */
     auto Sphere3::pop() -> array<double, 4> {
-        const auto ti = HALF_PI * this->vdc.pop();  // map to [0, pi/2];
-                                                    // const auto &tp = GL.getTp(2);
-                                                    // const auto xi = ::interp(GL.X, tp, ti);
-        const auto xi = ::interp(GL.getX(), GL.getF2(), ti);
-        const auto cosxi = cos(xi);
-        const auto sinxi = sin(xi);
+        array<double, 4> res;
+        this->pop_into(res);
+        return res;
+    }
+
+    /**
+     * @brief Generate the next point on the 3-sphere into a buffer
+     *
+     * @param res Output buffer receiving [x, y, z, w]
+     */
+    auto Sphere3::pop_into(span<double> res) -> void {
+        assert(res.size() == 4);
+        SPHERE_N_STATS_POP(sphere3, 3);
+        ++this->count;
+        const auto xi = TpInverse(2, this->inversion)(this->vdc.pop());
+        auto sinxi = 0.0;
+        auto cosxi = 0.0;
+        sin_cos(this->accuracy, xi, sinxi, cosxi);
         const auto [s0, s1, s2] = this->sphere2.pop();
-        return {sinxi * s0, sinxi * s1, sinxi * s2, cosxi};
+        res[0] = sinxi * s0;
+        res[1] = sinxi * s1;
+        res[2] = sinxi * s2;
+        res[3] = cosxi;
+    }
+
+    /**
+     * @brief Generate the next point on the 3-sphere and its inner S^2 point
+     *
+     * @param res Output buffers for the S^2 and the S^3 point
+     */
+    auto Sphere3::pop_nested(span<const span<double>> res) -> void {
+        assert(res.size() == 2 && res[0].size() == 3 && res[1].size() == 4);
+        SPHERE_N_STATS_POP(sphere3, 3);
+        ++this->count;
+        const auto xi = TpInverse(2, this->inversion)(this->vdc.pop());
+        auto sinxi = 0.0;
+        auto cosxi = 0.0;
+        sin_cos(this->accuracy, xi, sinxi, cosxi);
+        const auto s2 = this->sphere2.pop();
+        for (auto j = 0U; j != 3U; ++j) {
+            res[0][j] = s2[j];
+            res[1][j] = sinxi * s2[j];
+        }
+        res[1][3] = cosxi;
     }
 
     /**
@@ -248,24 +564,65 @@ namespace lds2 {
      * @param base Span containing base numbers for sequence generation
      *             - base[0]: base for VdCorput sequence (first dimension)
      *             - base[1..n]: bases for recursive sphere generator
+     * @param alloc Allocator for the nested generators
      *
      * The recursive structure allows generation of points on any n-sphere
      * by nesting lower-dimensional sphere generators.
      */
-    SphereN::SphereN(std::span<const unsigned long> base) : vdc{base[0]} {
+    SphereN::SphereN(std::span<const unsigned long> base, const allocator_type& alloc)
+        : b{base[0]}, vdc{base[0]} {
         const auto m = base.size();
         assert(m >= 4);
         // Arr tp_minus2;
+        auto* mr = alloc.resource();
         if (m == 4) {
-            this->s_gen = std::make_unique<Sphere3>(base.subspan(1, 3));
+            this->s_gen = make_pmr<Sphere3>(mr, base.subspan(1, 3));
         } else {
-            this->s_gen = std::make_unique<SphereN>(base.last(m - 1));
+            this->s_gen = make_pmr<SphereN>(mr, base.last(m - 1));  // alloc is propagated
         }
         this->n = m - 1;
         // this->tp = ((n - 1.0) * tp_minus2 + NEG_COSINE * xt::pow(SINE, n - 1.0))
         // / n;
     }
 
+    /**
+     * @brief Restore a SphereN object from a saved state
+     *
+     * @param state State returned by `state()`
+     * @param alloc Allocator for the nested generators
+     */
+    SphereN::SphereN(const GenState& state, const allocator_type& alloc)
+        : SphereN(checked_bases(state, "SphereN", 4), alloc) {
+        this->reseed(state.index);
+        this->set_inversion(state.inversion);
+        this->set_accuracy(state.accuracy);
+    }
+
+    /**
+     * @brief Allocator-extended copy constructor
+     *
+     * VdCorput and Sphere3 are plain values, so copying them copies their
+     * position; only the SphereN chain needs a deep copy.
+     *
+     * @param other The generator to copy
+     * @param alloc Allocator for the nested generators
+     */
+    SphereN::SphereN(const SphereN& other, const allocator_type& alloc)
+        : n{other.n},
+          b{other.b},
+          count{other.count},
+          inversion{other.inversion},
+          accuracy{other.accuracy},
+          vdc{other.vdc} {
+        auto* mr = alloc.resource();
+        std::visit(
+            [this, mr](const auto& t) {
+                using T = std::decay_t<decltype(*t)>;
+                this->s_gen = make_pmr<T>(mr, *t);  // alloc is propagated to SphereN
+            },
+            other.s_gen);
+    }
+
     /**
      * @brief Generate the next point on the n-sphere
      *
@@ -282,28 +639,85 @@ namespace lds2 {
      * 5. Transform: [sin(xi)*lower_dim_point, cos(xi)]
      */
     auto SphereN::pop() -> vector<double> {
-        const auto vd = this->vdc.pop();
-        const auto& tp = GL.getTp(this->n);
-        const auto ti = tp[0] + (tp[tp.size() - 1] - tp[0]) * vd;  // map to [t0, tm-1];
-        const auto xi = ::interp(GL.getX(), tp, ti);
-        const auto sinphi = sin(xi);
-
-        auto res = std::visit(
-            [](auto& t) {
-                using T = decltype(t->pop());
-                if constexpr (std::is_same_v<T, std::vector<double>>) {
-                    return t->pop();
-                } else {
-                    return to_vector(t->pop());
-                }
-            },
-            this->s_gen);
+        vector<double> res(this->size());
+        this->pop_into(res);
+        return res;
+    }
+
+    /**
+     * @brief Generate the next point on the n-sphere into a pmr vector
+     *
+     * @param mr The memory resource for the result
+     * @return std::pmr::vector<double> An (n+1)-dimensional point on the n-sphere
+     */
+    auto SphereN::pop(std::pmr::memory_resource* mr) -> std::pmr::vector<double> {
+        std::pmr::vector<double> res(this->size(), mr);
+        this->pop_into(res);
+        return res;
+    }
+
+    /**
+     * @brief Generate the next point on the n-sphere into a buffer
+     *
+     * The lower-dimensional point is generated in place in the leading
+     * `size() - 1` entries of `res` and then scaled by sin(xi).
+     *
+     * @param res Output buffer of size `size()`
+     */
+    auto SphereN::pop_into(span<double> res) -> void {
+        assert(res.size() == this->size());
+        SPHERE_N_STATS_POP(sphere_n, this->n + 1);
+        ++this->count;
+        const auto xi = TpInverse(this->n, this->inversion)(this->vdc.pop());
+        auto sinphi = 0.0;
+        auto cosphi = 0.0;
+        sin_cos(this->accuracy, xi, sinphi, cosphi);
 
-        for (auto& elem : res) {
+        const auto head = res.first(res.size() - 1);
+        std::visit([head](auto& t) { t->pop_into(head); }, this->s_gen);
+
+        for (auto& elem : head) {
             elem *= sinphi;
         }
-        res.emplace_back(cos(xi));
-        return res;
+        res.back() = cosphi;
+    }
+
+    /**
+     * @brief Generate the next point and the points of all nested levels
+     *
+     * The nested levels fill `res[0 .. levels() - 2]`; this level then
+     * scales the point of the level below by sin(xi) into `res.back()`.
+     *
+     * @param res `levels()` output buffers of sizes 3, 4, ..., `size()`
+     */
+    auto SphereN::pop_nested(span<const span<double>> res) -> void {
+        assert(res.size() == this->levels() && res.back().size() == this->size());
+        SPHERE_N_STATS_POP(sphere_n, this->n + 1);
+        ++this->count;
+        const auto xi = TpInverse(this->n, this->inversion)(this->vdc.pop());
+        auto sinphi = 0.0;
+        auto cosphi = 0.0;
+        sin_cos(this->accuracy, xi, sinphi, cosphi);
+
+        const auto inner = res.first(res.size() - 1);
+        std::visit([inner](auto& t) { t->pop_nested(inner); }, this->s_gen);
+
+        const auto below = inner.back();
+        const auto out = res.back();
+        for (auto j = size_t{0}; j != below.size(); ++j) {
+            out[j] = sinphi * below[j];
+        }
+        out.back() = cosphi;
+    }
+
+    /**
+     * @brief Get the allocator used for the nested generators
+     *
+     * @return SphereN::allocator_type
+     */
+    auto SphereN::get_allocator() const -> allocator_type {
+        return std::visit([](const auto& t) { return allocator_type(t.get_deleter().mr); },
+                          this->s_gen);
     }
 
     /**
@@ -316,7 +730,388 @@ namespace lds2 {
      * @param seed The seed value to reset to
      */
     auto SphereN::reseed(unsigned long seed) -> void {
+        this->count = seed;
         this->vdc.reseed(seed);
         std::visit([seed](auto& t) { t->reseed(seed); }, this->s_gen);
     }
+
+    /**
+     * @brief Append the bases of this level and all nested levels
+     *
+     * @param res Output list of bases, outermost first
+     */
+    auto SphereN::collect_bases(vector<unsigned long>& res) const -> void {
+        res.push_back(this->b);
+        std::visit(
+            [&res](const auto& t) {
+                using T = std::decay_t<decltype(*t)>;
+                if constexpr (std::is_same_v<T, Sphere3>) {
+                    const auto st = t->state();
+                    res.insert(res.end(), st.base.begin(), st.base.end());
+                } else {
+                    t->collect_bases(res);
+                }
+            },
+            this->s_gen);
+    }
+
+    /**
+     * @brief Snapshot of the bases, the current position and the modes
+     *
+     * @return GenState
+     */
+    auto SphereN::state() const -> GenState {
+        GenState res;
+        res.base.reserve(this->n + 1);
+        this->collect_bases(res.base);
+        res.index = this->count;
+        res.inversion = this->inversion;
+        res.accuracy = this->accuracy;
+        return res;
+    }
+
+    /**
+     * @brief Map points of the unit hypercube onto S^m
+     *
+     * The innermost S^2 point is built first (same formulas as
+     * `ldsgen::Sphere`), then each outer level scales the lower-dimensional
+     * point by sin(xi) and appends cos(xi), as in `SphereN::pop_into()`.
+     * Rows are processed in blocks of MAP_BLOCK: the angles of a block are
+     * computed first, then their sines and cosines in one `sin_cos()` call,
+     * which vectorizes for the polynomial accuracy policies.
+     *
+     * With a compile-time `Dim` every level is instantiated with its
+     * length as a constant, so the row loops are fully unrolled. The
+     * function is always inlined, so a caller compiled for a wider
+     * instruction set gets its own copy of the whole kernel.
+     *
+     * @tparam Dim `size_t`, or `std::integral_constant<size_t, M>` for a fixed m
+     * @tparam MakeInverse Callable returning the `TpInverse` of a dimension
+     * @param m_dim Number of sequence values per point
+     * @param u Row-major input values
+     * @param res Row-major output coordinates
+     * @param acc Accuracy policy of the sin/cos evaluations
+     * @param make_inverse Provides the Tp inversion of each level
+     */
+    template <typename Dim, typename MakeInverse>
+    SPHERE_N_ALWAYS_INLINE static inline auto map_levels(Dim m_dim, span<const double> u,
+                                                         span<double> res, Accuracy acc,
+                                                         MakeInverse&& make_inverse) -> void {
+        const size_t m = m_dim;
+        assert(m >= 3);
+        SPHERE_N_TRACE_SCOPE("lds2::map_sphere_n");
+        const auto count = u.size() / m;
+        assert(u.size() == count * m && res.size() == count * (m + 1));
+        const auto stride = m + 1;
+        constexpr size_t MAP_BLOCK = 64;
+        array<double, MAP_BLOCK> angle;
+        array<double, MAP_BLOCK> sina;
+        array<double, MAP_BLOCK> cosa;
+
+        // innermost S^2: z = 2u - 1, circle angle 2 pi u
+        for (auto r0 = size_t{0}; r0 < count; r0 += MAP_BLOCK) {
+            const auto nb = std::min(MAP_BLOCK, count - r0);
+            const auto ang = span<double>(angle).first(nb);
+            for (auto r = 0U; r != nb; ++r) {
+                ang[r] = 2.0 * PI * u[(r0 + r) * m + m - 1];
+            }
+            sin_cos(acc, ang, span<double>(sina).first(nb), span<double>(cosa).first(nb));
+            for (auto r = 0U; r != nb; ++r) {
+                auto* xr = &res[(r0 + r) * stride];
+                const auto cosphi = 2.0 * u[(r0 + r) * m + m - 2] - 1.0;
+                const auto sinphi = sqrt(1.0 - cosphi * cosphi);
+                xr[0] = sinphi * cosa[r];
+                xr[1] = sinphi * sina[r];
+                xr[2] = cosphi;
+            }
+        }
+
+        // S^3 level (Sphere3) and S^n levels (SphereN), innermost first
+        const auto level = [&](auto len_c) {
+            const size_t len = len_c;
+            const auto i = m - len;  // index of the sequence value of this level
+            const auto tp_inverse = make_inverse(len - 1);
+            for (auto r0 = size_t{0}; r0 < count; r0 += MAP_BLOCK) {
+                const auto nb = std::min(MAP_BLOCK, count - r0);
+                const auto ang = span<double>(angle).first(nb);
+                for (auto r = 0U; r != nb; ++r) {
+                    ang[r] = tp_inverse(u[(r0 + r) * m + i]);
+                }
+                sin_cos(acc, ang, span<double>(sina).first(nb), span<double>(cosa).first(nb));
+                for (auto r = 0U; r != nb; ++r) {
+                    auto* xr = &res[(r0 + r) * stride];
+                    for (auto j = 0U; j != len; ++j) {
+                        xr[j] *= sina[r];
+                    }
+                    xr[len] = cosa[r];
+                }
+            }
+        };
+        if constexpr (std::is_integral_v<Dim>) {
+            for (auto len = size_t{3}; len != stride; ++len) {
+                level(len);
+            }
+        } else {
+            [&]<size_t... L>(std::index_sequence<L...>) {
+                (level(std::integral_constant<size_t, L + 3>{}), ...);
+            }(std::make_index_sequence<Dim::value - 2>{});
+        }
+    }
+
+    /**
+     * @brief Map points of the unit hypercube onto S^m
+     *
+     * @param m Number of sequence values per point
+     * @param u Row-major input values
+     * @param res Row-major output coordinates
+     * @param mode Tp inversion method
+     * @param acc Accuracy policy of the sin/cos evaluations
+     */
+    auto map_sphere_n(size_t m, span<const double> u, span<double> res, Inversion mode,
+                      Accuracy acc) -> void {
+        map_levels(m, u, res, acc, [mode](size_t n) { return TpInverse(n, mode); });
+    }
+
+    /**
+     * @brief Map points of the unit hypercube onto S^m with private table copies
+     *
+     * @param m Number of sequence values per point
+     * @param u Row-major input values
+     * @param res Row-major output coordinates
+     * @param tables Copies of the interpolation tables, `tables.dims() >= m`
+     * @param acc Accuracy policy of the sin/cos evaluations
+     */
+    auto map_sphere_n(size_t m, span<const double> u, span<double> res, const TpTables& tables,
+                      Accuracy acc) -> void {
+        assert(tables.dims() >= m);
+        map_levels(m, u, res, acc, [&tables](size_t n) {
+            return TpInverse(n, tables.grid(), tables.table(n));
+        });
+    }
+
+    /**
+     * @brief Map points of the unit hypercube onto S^m with the given mapping
+     *
+     * @param mapping Mapping of the sequence values
+     * @param m Number of sequence values per point
+     * @param u Row-major input values
+     * @param res Row-major output coordinates
+     * @param mode Tp inversion method of `Mapping::sphere`
+     * @param acc Accuracy policy of the sin/cos evaluations
+     */
+    auto map_points(Mapping mapping, size_t m, span<const double> u, span<double> res,
+                    Inversion mode, Accuracy acc) -> void {
+        if (mapping == Mapping::sphere && m >= 3) {
+            map_sphere_n(m, u, res, mode, acc);
+        } else {
+            map_cylind_n(m, u, res, acc);
+        }
+    }
+
+    /**
+     * @brief `map_sphere_n()` for a fixed number of sequence values
+     *
+     * @tparam M Number of sequence values per point
+     * @param m Number of sequence values per point, equal to M
+     * @param u Row-major input values
+     * @param res Row-major output coordinates
+     * @param mode Tp inversion method
+     * @param acc Accuracy policy of the sin/cos evaluations
+     */
+    template <size_t M>
+    static auto map_fixed([[maybe_unused]] size_t m, span<const double> u, span<double> res,
+                          Inversion mode, Accuracy acc) -> void {
+        assert(m == M);
+        map_levels(std::integral_constant<size_t, M>{}, u, res, acc,
+                   [mode](size_t n) { return TpInverse(n, mode); });
+    }
+
+#if SPHERE_N_HAS_AVX2_KERNELS
+    /**
+     * @brief `map_fixed()` compiled for AVX2
+     *
+     * FMA is left disabled, so contraction cannot change the rounding and
+     * the results are bit-identical to the generic kernel.
+     */
+    template <size_t M>
+    [[gnu::target("avx2")]] static auto map_fixed_avx2([[maybe_unused]] size_t m,
+                                                        span<const double> u, span<double> res,
+                                                        Inversion mode, Accuracy acc) -> void {
+        assert(m == M);
+        map_levels(std::integral_constant<size_t, M>{}, u, res, acc,
+                   [mode](size_t n) { return TpInverse(n, mode); });
+    }
+
+    /**
+     * @brief `map_sphere_n()` compiled for AVX2
+     */
+    [[gnu::target("avx2")]] static auto map_flat_avx2(size_t m, span<const double> u,
+                                                       span<double> res, Inversion mode,
+                                                       Accuracy acc) -> void {
+        map_levels(m, u, res, acc, [mode](size_t n) { return TpInverse(n, mode); });
+    }
+#endif
+
+    /**
+     * @brief Instruction set of the kernels to select on this CPU
+     *
+     * @return Isa
+     */
+    auto detect_isa() -> Isa {
+#if SPHERE_N_HAS_AVX2_KERNELS
+        static const auto isa = __builtin_cpu_supports("avx2") ? Isa::avx2 : Isa::generic;
+        return isa;
+#else
+        return Isa::generic;
+#endif
+    }
+
+    /**
+     * @brief Fastest `map_sphere_n()` kernel for m sequence values
+     *
+     * @param m Number of sequence values per point
+     * @param isa Instruction set, at most `detect_isa()`
+     * @return MapKernel
+     */
+    auto select_map_kernel(size_t m, Isa isa) -> MapKernel {
+        assert(m >= 3);
+        constexpr auto fixed = []<size_t... I>(std::index_sequence<I...>) {
+            return array<MapKernel, sizeof...(I)>{&map_fixed<I + 3>...};
+        }(std::make_index_sequence<FIXED_MAP_MAX - 2>{});
+#if SPHERE_N_HAS_AVX2_KERNELS
+        constexpr auto fixed_avx2 = []<size_t... I>(std::index_sequence<I...>) {
+            return array<MapKernel, sizeof...(I)>{&map_fixed_avx2<I + 3>...};
+        }(std::make_index_sequence<FIXED_MAP_MAX - 2>{});
+        if (isa == Isa::avx2) {
+            return (m <= FIXED_MAP_MAX) ? fixed_avx2[m - 3] : &map_flat_avx2;
+        }
+#else
+        (void)isa;
+#endif
+        return (m <= FIXED_MAP_MAX) ? fixed[m - 3] : MapKernel{&map_sphere_n};
+    }
+
+    /**
+     * @brief Copy the interpolation tables of the levels of S^m
+     *
+     * @param m Number of sequence values per point
+     */
+    TpTables::TpTables(size_t m) : x_grid(GL.getX()), m{m} {
+        this->tables.reserve(m > 2 ? m - 2 : 0);
+        for (auto n = size_t{2}; n < m; ++n) {
+            this->tables.push_back((n == 2) ? GL.getF2() : GL.getTp(n));
+        }
+    }
+
+    /**
+     * @brief Map points on S^m back to the values of the unit hypercube
+     *
+     * Level len of `map_sphere_n()` scales x[0..len) by sin(xi) and sets
+     * x[len] = cos(xi), so xi = atan2(|x[0..len)|, x[len]) and the scaling
+     * of the lower levels cancels. The squared norms of the prefixes are
+     * accumulated innermost first, which peels all levels in one pass over
+     * each row instead of renormalizing the row per level. As in the forward
+     * map, the angles of a block are gathered first and converted level by
+     * level with one Tp table per level.
+     *
+     * @param m Number of sequence values per point
+     * @param x Row-major input coordinates
+     * @param u Row-major output values
+     * @param mode Tp inversion method the points were generated with
+     */
+    auto inverse_sphere_n(size_t m, span<const double> x, span<double> u, Inversion mode)
+        -> void {
+        assert(m >= 3);
+        SPHERE_N_TRACE_SCOPE("lds2::inverse_sphere_n");
+        const auto stride = m + 1;
+        const auto count = x.size() / stride;
+        assert(x.size() == count * stride && u.size() == count * m);
+        constexpr size_t MAP_BLOCK = 64;
+        array<double, MAP_BLOCK> norm2;
+        array<double, MAP_BLOCK> angle;
+
+        for (auto r0 = size_t{0}; r0 < count; r0 += MAP_BLOCK) {
+            const auto nb = std::min(MAP_BLOCK, count - r0);
+            // innermost S^2: circle angle and z
+            for (auto r = 0U; r != nb; ++r) {
+                const auto* xr = &x[(r0 + r) * stride];
+                auto* ur = &u[(r0 + r) * m];
+                auto phi = std::atan2(xr[1], xr[0]) / (2.0 * PI);
+                phi += (phi < 0.0) ? 1.0 : 0.0;
+                ur[m - 1] = (phi < 1.0) ? phi : 0.0;
+                norm2[r] = xr[0] * xr[0] + xr[1] * xr[1];
+                const auto len = sqrt(norm2[r] + xr[2] * xr[2]);
+                ur[m - 2] = (len > 0.0) ? std::clamp(0.5 * (xr[2] / len + 1.0), 0.0, 1.0) : 0.5;
+                norm2[r] += xr[2] * xr[2];
+            }
+            // S^3 level and S^n levels, innermost first
+            for (auto len = size_t{3}; len != stride; ++len) {
+                const auto tp_forward = TpForward(len - 1, mode);
+                for (auto r = 0U; r != nb; ++r) {
+                    const auto c = x[(r0 + r) * stride + len];
+                    angle[r] = std::atan2(sqrt(norm2[r]), c);
+                    norm2[r] += c * c;
+                }
+                for (auto r = 0U; r != nb; ++r) {
+                    u[(r0 + r) * m + m - len] = tp_forward(angle[r]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Select the accuracy policy of this and all nested levels
+     *
+     * @param acc Accuracy policy
+     */
+    auto SphereN::set_accuracy(Accuracy acc) -> void {
+        this->accuracy = acc;
+        std::visit([acc](auto& t) { t->set_accuracy(acc); }, this->s_gen);
+    }
+
+    /**
+     * @brief Select the inversion method of this and all nested levels
+     *
+     * @param mode Inversion method
+     */
+    auto SphereN::set_inversion(Inversion mode) -> void {
+        this->inversion = mode;
+        std::visit([mode](auto& t) { t->set_inversion(mode); }, this->s_gen);
+    }
+
+    /**
+     * @brief Tp(n) at x
+     *
+     * @param n Dimension parameter
+     * @param x The angle
+     * @return double
+     */
+    auto tp_value(size_t n, double x) -> double {
+        auto sinn = 0.0;
+        return ::tp_value_sc(n, x, sin(x), cos(x), sinn);
+    }
+
+    /**
+     * @brief Inverse of the normalized Tp CDF
+     *
+     * @param n Dimension parameter
+     * @param u Value in [0, 1]
+     * @param mode Inversion method
+     * @return double Angle in [0, π]
+     */
+    auto tp_inverse(size_t n, double u, Inversion mode) -> double {
+        return TpInverse(n, mode)(u);
+    }
+
+    /**
+     * @brief Normalized Tp CDF
+     *
+     * @param n Dimension parameter
+     * @param xi Angle in [0, π]
+     * @param mode Inversion method
+     * @return double Value in [0, 1]
+     */
+    auto tp_cdf(size_t n, double xi, Inversion mode) -> double {
+        return TpForward(n, mode)(xi);
+    }
 }  // namespace lds2
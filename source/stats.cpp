@@ -0,0 +1,221 @@
+#include <array>               // for array
+#include <atomic>              // for atomic, memory_order_relaxed
+#include <cstddef>             // for size_t
+#include <cstdint>             // for uint64_t
+#include <deque>               // for deque
+#include <mutex>               // for mutex, scoped_lock
+#include <sphere_n/stats.hpp>  // for StatsSnapshot, TraceHooks
+#include <vector>              // for vector
+
+#ifdef SPHERE_N_STATS
+
+/** @brief Number of scalar counters in `lds2::detail::Counter` */
+static constexpr size_t N_COUNTERS = 8;
+
+/**
+ * @brief Counters of one thread
+ *
+ * Only the owning thread increments a block, so the increments are plain
+ * relaxed load/store pairs without a locked instruction or cache-line
+ * sharing. Readers sum all blocks.
+ */
+struct alignas(64) StatsBlock {
+    std::array<std::atomic<std::uint64_t>, N_COUNTERS> counters{};
+    std::array<std::array<std::atomic<std::uint64_t>, lds2::STATS_MAX_DIM + 1>, lds2::POP_KINDS>
+        pops{};
+};
+
+/**
+ * @brief All counter blocks ever handed out
+ *
+ * Blocks of finished threads are recycled rather than freed, so their
+ * counts remain part of the totals.
+ */
+struct StatsRegistry {
+    std::mutex mutex;
+    std::deque<StatsBlock> blocks;
+    std::vector<StatsBlock*> free_blocks;
+};
+
+/**
+ * @brief The registry, intentionally leaked so that it outlives thread-local handles
+ * @return StatsRegistry&
+ */
+static auto registry() -> StatsRegistry& {
+    static auto* reg = new StatsRegistry{};
+    return *reg;
+}
+
+/**
+ * @brief Thread-local owner of a counter block
+ */
+struct StatsHandle {
+    StatsBlock* block;
+
+    StatsHandle() {
+        auto& reg = registry();
+        std::scoped_lock lock(reg.mutex);
+        if (reg.free_blocks.empty()) {
+            this->block = &reg.blocks.emplace_back();
+        } else {
+            this->block = reg.free_blocks.back();
+            reg.free_blocks.pop_back();
+        }
+    }
+
+    StatsHandle(const StatsHandle&) = delete;
+    auto operator=(const StatsHandle&) -> StatsHandle& = delete;
+
+    ~StatsHandle() {
+        auto& reg = registry();
+        std::scoped_lock lock(reg.mutex);
+        reg.free_blocks.push_back(this->block);
+    }
+};
+
+/**
+ * @brief Counter block of the calling thread
+ * @return StatsBlock&
+ */
+static auto local_block() -> StatsBlock& {
+    thread_local StatsHandle handle;
+    return *handle.block;
+}
+
+/**
+ * @brief Add to a counter owned by the calling thread
+ *
+ * @param counter The counter
+ * @param value The increment
+ */
+static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+/** @brief Installed trace marker callbacks */
+static std::atomic<void (*)(const char*)> trace_begin_hook{nullptr};
+static std::atomic<void (*)(const char*)> trace_end_hook{nullptr};
+
+#endif
+
+namespace lds2 {
+    /**
+     * @brief Sum of the counters of all threads
+     *
+     * @return StatsSnapshot
+     */
+    auto stats_snapshot() -> StatsSnapshot {
+        StatsSnapshot res;
+#ifdef SPHERE_N_STATS
+        res.enabled = true;
+        std::array<std::uint64_t, N_COUNTERS> sums{};
+        auto& reg = registry();
+        std::scoped_lock lock(reg.mutex);
+        for (const auto& block : reg.blocks) {
+            for (auto i = 0U; i != N_COUNTERS; ++i) {
+                sums[i] += block.counters[i].load(std::memory_order_relaxed);
+            }
+            for (auto k = 0U; k != POP_KINDS; ++k) {
+                for (auto d = 0U; d != STATS_MAX_DIM + 1; ++d) {
+                    res.pops[k][d] += block.pops[k][d].load(std::memory_order_relaxed);
+                }
+            }
+        }
+        using detail::Counter;
+        const auto get = [&sums](Counter c) { return sums[static_cast<size_t>(c)]; };
+        res.tp_builds = get(Counter::tp_builds);
+        res.tp_build_ns = get(Counter::tp_build_ns);
+        res.tp_cache_hits = get(Counter::tp_cache_hits);
+        res.tp_cache_misses = get(Counter::tp_cache_misses);
+        res.interp_calls = get(Counter::interp_calls);
+        res.interp_ns = get(Counter::interp_ns);
+        res.lock_contended = get(Counter::lock_contended);
+        res.lock_wait_ns = get(Counter::lock_wait_ns);
+#endif
+        return res;
+    }
+
+    /**
+     * @brief Reset all counters to zero
+     */
+    auto stats_reset() -> void {
+#ifdef SPHERE_N_STATS
+        auto& reg = registry();
+        std::scoped_lock lock(reg.mutex);
+        for (auto& block : reg.blocks) {
+            for (auto& c : block.counters) {
+                c.store(0, std::memory_order_relaxed);
+            }
+            for (auto& row : block.pops) {
+                for (auto& c : row) {
+                    c.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Install trace marker callbacks
+     *
+     * @param hooks The callbacks
+     */
+    auto set_trace_hooks([[maybe_unused]] TraceHooks hooks) -> void {
+#ifdef SPHERE_N_STATS
+        trace_begin_hook.store(hooks.begin, std::memory_order_release);
+        trace_end_hook.store(hooks.end, std::memory_order_release);
+#endif
+    }
+
+    namespace detail {
+        /**
+         * @brief Add to a scalar counter of the calling thread
+         *
+         * @param counter The counter
+         * @param value The increment
+         */
+        auto stats_add([[maybe_unused]] Counter counter, [[maybe_unused]] std::uint64_t value)
+            -> void {
+#ifdef SPHERE_N_STATS
+            bump(local_block().counters[static_cast<size_t>(counter)], value);
+#endif
+        }
+
+        /**
+         * @brief Count generated points
+         *
+         * @param kind Generator kind
+         * @param dim Dimension of the sphere
+         * @param count Number of points
+         */
+        auto stats_pop([[maybe_unused]] PopKind kind, [[maybe_unused]] size_t dim,
+                       [[maybe_unused]] std::uint64_t count) -> void {
+#ifdef SPHERE_N_STATS
+            const auto d = (dim < STATS_MAX_DIM) ? dim : STATS_MAX_DIM;
+            bump(local_block().pops[static_cast<size_t>(kind)][d], count);
+#endif
+        }
+
+        /**
+         * @brief Forward a region start to the installed trace hook
+         *
+         * @param name Region name
+         */
+        auto trace_begin([[maybe_unused]] const char* name) -> void {
+#ifdef SPHERE_N_STATS
+            if (auto* hook = trace_begin_hook.load(std::memory_order_acquire)) hook(name);
+#endif
+        }
+
+        /**
+         * @brief Forward a region end to the installed trace hook
+         *
+         * @param name Region name
+         */
+        auto trace_end([[maybe_unused]] const char* name) -> void {
+#ifdef SPHERE_N_STATS
+            if (auto* hook = trace_end_hook.load(std::memory_order_acquire)) hook(name);
+#endif
+        }
+    }  // namespace detail
+}  // namespace lds2
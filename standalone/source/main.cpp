@@ -1,17 +1,78 @@
 #include <sphere_n/version.h>  // for SPHERE_N_VERSION
 
-#include <cxxopts.hpp>    // for value, OptionAdder, Options, OptionValue
-#include <iostream>       // for string, operator<<, endl, basic_ostream
-#include <memory>         // for shared_ptr
-#include <string>         // for char_traits, hash, operator==
-#include <unordered_map>  // for operator==, unordered_map, __hash_map_const...
-#include <utility>        // for pair
+#include <cstddef>                  // for size_t
+#include <cxxopts.hpp>              // for value, OptionAdder, Options, OptionValue
+#include <iostream>                 // for string, operator<<, endl, basic_ostream, cerr
+#include <iterator>                 // for size
+#include <exception>                // for exception
+#include <memory>                   // for shared_ptr
+#include <span>                     // for span
+#include <sphere_n/point_ring.hpp>  // for PointRing, PointBlock
+#include <sphere_n/sphere_n.hpp>    // for SphereN, PRIME_TABLE
+#include <string>                   // for char_traits, hash, operator==
+#include <unordered_map>            // for operator==, unordered_map, __hash_map_const...
+#include <utility>                  // for pair
+
+/**
+ * @brief Serve SphereN points through a shared-memory ring
+ *
+ * Blocks while the ring is full, so at least one consumer must attach.
+ *
+ * @param name Name of the shared-memory object
+ * @param dim Dimension of the sphere (points have dim + 1 coordinates)
+ * @param blocks Number of blocks to publish
+ * @param block_points Points per block
+ * @param slots Number of slots of the ring
+ * @return int Exit code
+ */
+static auto serve(const std::string& name, size_t dim, size_t blocks, size_t block_points,
+                  size_t slots) -> int {
+    // SphereN needs at least 4 bases, and they are taken from PRIME_TABLE
+    if (dim < 4 || dim > std::size(lds2::PRIME_TABLE)) {
+        std::cerr << "--dim must be between 4 and " << std::size(lds2::PRIME_TABLE) << '\n';
+        return 1;
+    }
+    auto ring = lds2::PointRing::create_shared(name, dim + 1, block_points, slots);
+    auto gen = lds2::SphereN(std::span<const unsigned long>(lds2::PRIME_TABLE, dim));
+    gen.reseed(0);
+    std::cout << "serving S^" << dim << " on " << name << '\n';
+    for (auto i = size_t{0}; i != blocks; ++i) {
+        ring.produce(gen);
+    }
+    // the name is unlinked on return; attached consumers keep their mapping and drain the ring
+    ring.close();
+    return 0;
+}
+
+/**
+ * @brief Consume blocks from a shared-memory ring until it is closed
+ *
+ * @param name Name of the shared-memory object
+ * @return int Exit code
+ */
+static auto consume(const std::string& name) -> int {
+    auto ring = lds2::PointRing::open_shared(name);
+    auto block = lds2::PointBlock{};
+    auto n_blocks = size_t{0};
+    auto sum = 0.0;
+    while (ring.claim(block)) {
+        for (const auto v : block.points()) {
+            sum += v;
+        }
+        block.release();
+        ++n_blocks;
+    }
+    std::cout << n_blocks << " blocks, coordinate sum " << sum << '\n';
+    return 0;
+}
 
 /**
  * @brief Main entry point for the SphereN standalone application
  *
  * This program provides a command-line interface for the SphereN library.
- * It currently supports displaying help information and version details.
+ * It supports displaying help information and version details, and serving
+ * or consuming SphereN points through a shared-memory ring (`--serve NAME`
+ * in one process, `--consume NAME` in any number of others).
  *
  * @param argc Number of command-line arguments
  * @param argv Array of command-line argument strings
@@ -22,6 +83,12 @@ auto main(int argc, char** argv) -> int {
 
     std::string language;
     std::string name;
+    std::string serve_name;
+    std::string consume_name;
+    size_t dim = 0;
+    size_t blocks = 0;
+    size_t block_points = 0;
+    size_t slots = 0;
 
     // clang-format off
   options.add_options()
@@ -29,6 +96,12 @@ auto main(int argc, char** argv) -> int {
     ("v,version", "Print the current version number")
     ("n,name", "Name to greet", cxxopts::value(name)->default_value("World"))
     ("l,lang", "Language code to use", cxxopts::value(language)->default_value("en"))
+    ("serve", "Serve SphereN points on a shared-memory ring", cxxopts::value(serve_name))
+    ("consume", "Consume points from a shared-memory ring", cxxopts::value(consume_name))
+    ("dim", "Dimension of the served sphere (>= 4)", cxxopts::value(dim)->default_value("4"))
+    ("blocks", "Number of blocks to serve", cxxopts::value(blocks)->default_value("1000"))
+    ("block-points", "Points per block", cxxopts::value(block_points)->default_value("256"))
+    ("slots", "Slots of the ring", cxxopts::value(slots)->default_value("16"))
   ;
     // clang-format on
 
@@ -44,5 +117,18 @@ auto main(int argc, char** argv) -> int {
         return 0;
     }
 
+    try {
+        if (result.count("serve") != 0) {
+            return serve(serve_name, dim, blocks, block_points, slots);
+        }
+
+        if (result.count("consume") != 0) {
+            return consume(consume_name);
+        }
+    } catch (const std::exception& e) {  // e.g. a bad ring geometry or a missing ring
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
     return 0;
 }
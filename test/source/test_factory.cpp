@@ -0,0 +1,118 @@
+#include <doctest/doctest.h>  // for Approx, ResultBuilder, TestCase
+
+#include <cstddef>                // for size_t
+#include <span>                   // for span
+#include <sphere_n/cylind_n.hpp>  // for CylindN, map_cylind_n
+#include <sphere_n/factory.hpp>   // for make_generator, GeneratorKind, GeneratorOptions
+#include <sphere_n/halton_n.hpp>  // for HaltonN
+#include <sphere_n/sphere_n.hpp>  // for SphereN, Sphere3, Sphere, PRIME_TABLE, select_map_kernel
+#include <stdexcept>              // for invalid_argument
+#include <vector>                 // for vector
+
+TEST_CASE("make_generator (sphere kernels match SphereN and Sphere3)") {
+    for (const auto dim : {size_t{4}, size_t{5}, size_t{9}, size_t{12}}) {
+        const auto base = std::span<const unsigned long>(lds2::PRIME_TABLE, dim - 1);
+        for (const auto simd : {false, true}) {
+            auto opts = lds2::GeneratorOptions{};
+            opts.simd = simd;
+            opts.seed = 10;
+            auto gen = lds2::make_generator(lds2::GeneratorKind::sphere, dim, opts);
+            REQUIRE_EQ(gen.size(), dim);
+            CHECK_EQ(gen.name().find(dim <= 9 ? "fixed" : "flat"), 7U);
+            std::vector<double> batch(300 * dim);
+            gen.pop_batch(batch);
+            std::vector<double> ref(dim);
+            if (dim == 4) {
+                auto sp3 = lds2::Sphere3(base);
+                sp3.reseed(10);
+                for (auto k = size_t{0}; k != 300; ++k) {
+                    sp3.pop_into(ref);
+                    for (auto i = size_t{0}; i != dim; ++i) {
+                        CHECK_EQ(batch[k * dim + i], doctest::Approx(ref[i]).epsilon(1e-12));
+                    }
+                }
+            } else {
+                auto spn = lds2::SphereN(base);
+                spn.reseed(10);
+                for (auto k = size_t{0}; k != 300; ++k) {
+                    spn.pop_into(ref);
+                    for (auto i = size_t{0}; i != dim; ++i) {
+                        CHECK_EQ(batch[k * dim + i], doctest::Approx(ref[i]).epsilon(1e-12));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("make_generator (sphere on S^2 matches Sphere)") {
+    auto opts = lds2::GeneratorOptions{};
+    opts.seed = 10;
+    auto gen = lds2::make_generator(lds2::GeneratorKind::sphere, 3, opts);
+    REQUIRE_EQ(gen.size(), 3U);
+    CHECK_EQ(gen.name(), "sphere/cylind");
+    std::vector<double> batch(300 * 3);
+    gen.pop_batch(batch);
+    auto sphere = lds2::Sphere(2, 3);
+    sphere.reseed(10);
+    for (auto k = size_t{0}; k != 300; ++k) {
+        const auto x = sphere.pop();
+        for (auto i = size_t{0}; i != 3; ++i) {
+            CHECK_EQ(batch[k * 3 + i], doctest::Approx(x[i]).epsilon(1e-12));
+        }
+    }
+}
+
+TEST_CASE("make_generator (kernel variants agree bit for bit)") {
+    for (auto m = size_t{3}; m != 14; ++m) {
+        std::vector<double> u(100 * m);
+        auto halton = lds2::HaltonN(m);
+        halton.pop_batch(u);
+        std::vector<double> flat(100 * (m + 1));
+        std::vector<double> generic(100 * (m + 1));
+        std::vector<double> native(100 * (m + 1));
+        lds2::map_sphere_n(m, u, flat, lds2::Inversion::interp, lds2::Accuracy::high);
+        lds2::select_map_kernel(m, lds2::Isa::generic)(m, u, generic, lds2::Inversion::interp,
+                                                       lds2::Accuracy::high);
+        lds2::select_map_kernel(m, lds2::detect_isa())(m, u, native, lds2::Inversion::interp,
+                                                       lds2::Accuracy::high);
+        CHECK_EQ(generic, flat);
+        CHECK_EQ(native, flat);
+    }
+}
+
+TEST_CASE("make_generator (cylind, halton, copies and errors)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    auto cyl = lds2::make_generator(lds2::GeneratorKind::cylind, 5);
+    auto ref = lds2::CylindN(base);
+    for (auto k = 0; k != 50; ++k) {
+        const auto x = cyl.pop();
+        const auto y = ref.pop();
+        for (auto i = size_t{0}; i != 5; ++i) {
+            CHECK_EQ(x[i], doctest::Approx(y[i]).epsilon(1e-12));
+        }
+    }
+
+    auto hal = lds2::make_generator(lds2::GeneratorKind::halton, 4);
+    auto href = lds2::HaltonN(base);
+    hal.skip(3);
+    href.skip(3);
+    auto copy = hal;
+    const auto first = hal.pop();
+    CHECK_EQ(first, href.pop());
+    CHECK_EQ(copy.pop(), first);
+    CHECK_EQ(hal.name(), "halton/flat");
+
+    // the cylindrical kernel honours the accuracy policy
+    auto opts = lds2::GeneratorOptions{};
+    opts.accuracy = lds2::Accuracy::fast;
+    auto fast = lds2::make_generator(lds2::GeneratorKind::cylind, 5, opts);
+    std::vector<double> u(4);
+    lds2::HaltonN(base).pop_into(u);
+    std::vector<double> expected(5);
+    lds2::map_cylind_n(4, u, expected, lds2::Accuracy::fast);
+    CHECK_EQ(fast.pop(), expected);
+
+    CHECK_THROWS_AS(lds2::make_generator(lds2::GeneratorKind::sphere, 2), std::invalid_argument);
+    CHECK_THROWS_AS(lds2::make_generator(lds2::GeneratorKind::halton, 0), std::invalid_argument);
+}
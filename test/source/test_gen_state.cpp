@@ -0,0 +1,98 @@
+#include <doctest/doctest.h>  // for ResultBuilder, TestCase
+
+#include <iterator>                // for begin, end
+#include <sphere_n/cylind_n.hpp>   // for CylindN
+#include <sphere_n/gen_state.hpp>  // for GenState, read_state, write_state
+#include <sphere_n/halton_n.hpp>   // for HaltonN
+#include <sphere_n/sphere_n.hpp>   // for Sphere3, SphereN
+#include <sstream>                 // for stringstream
+#include <stdexcept>               // for runtime_error, invalid_argument
+#include <vector>                  // for vector
+
+TEST_CASE("SphereN clone") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    auto spgen = lds2::SphereN(base);
+    spgen.pop();
+    spgen.pop();
+    auto copy = spgen.clone();
+    const auto res1 = spgen.pop();
+    const auto res2 = copy.pop();
+    CHECK_EQ(res1, res2);
+}
+
+TEST_CASE("SphereN state") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    auto spgen = lds2::SphereN(base);
+    spgen.reseed(5);
+    spgen.pop();
+    const auto state = spgen.state();
+    const auto expected = std::vector<unsigned long>(std::begin(base), std::end(base));
+    CHECK_EQ(state.base, expected);
+    CHECK_EQ(state.index, 6U);
+
+    std::stringstream ss;
+    lds2::write_state(ss, state);
+    auto restored = lds2::SphereN(lds2::read_state(ss));
+    CHECK_EQ(spgen.pop(), restored.pop());
+}
+
+TEST_CASE("CylindN clone and state") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    auto cygen = lds2::CylindN(base);
+    cygen.pop();
+    auto copy = cygen.clone();
+    auto restored = lds2::CylindN(cygen.state());
+    const auto expected = std::vector<unsigned long>(std::begin(base), std::end(base));
+    CHECK_EQ(cygen.state().base, expected);
+    const auto res = cygen.pop();
+    CHECK_EQ(res, copy.pop());
+    CHECK_EQ(res, restored.pop());
+}
+
+TEST_CASE("Sphere3 state") {
+    const unsigned long base[] = {2, 3, 5};
+    auto sp3gen = lds2::Sphere3(base);
+    sp3gen.pop();
+    auto restored = lds2::Sphere3(sp3gen.state());
+    CHECK_EQ(sp3gen.pop(), restored.pop());
+}
+
+TEST_CASE("SphereN state (modes)") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    auto spgen = lds2::SphereN(base);
+    spgen.set_inversion(lds2::Inversion::newton);
+    spgen.set_accuracy(lds2::Accuracy::fast);
+    spgen.pop();
+    std::stringstream ss;
+    lds2::write_state(ss, spgen.state());
+    const auto state = lds2::read_state(ss);
+    CHECK(state.inversion == lds2::Inversion::newton);
+    CHECK(state.accuracy == lds2::Accuracy::fast);
+    auto restored = lds2::SphereN(state);
+    CHECK_EQ(spgen.pop(), restored.pop());
+}
+
+TEST_CASE("read_state (malformed)") {
+    std::stringstream ss("not a state");
+    CHECK_THROWS_AS(lds2::read_state(ss), std::runtime_error);
+}
+
+TEST_CASE("restore (malformed state)") {
+    auto too_few = lds2::GenState{};
+    too_few.base = {2, 3, 5};
+    CHECK_THROWS_AS(lds2::SphereN{too_few}, std::invalid_argument);
+    CHECK_NOTHROW(lds2::Sphere3{too_few});
+
+    auto too_many = too_few;
+    too_many.base.push_back(7);
+    CHECK_THROWS_AS(lds2::Sphere3{too_many}, std::invalid_argument);
+
+    auto bad_base = lds2::GenState{};
+    bad_base.base = {2, 1, 5, 7};
+    bad_base.index = 3;
+    CHECK_THROWS_AS(lds2::SphereN{bad_base}, std::invalid_argument);
+    CHECK_THROWS_AS(lds2::CylindN{bad_base}, std::invalid_argument);
+    CHECK_THROWS_AS(lds2::HaltonN{bad_base}, std::invalid_argument);
+
+    CHECK_THROWS_AS(lds2::CylindN{lds2::GenState{}}, std::invalid_argument);
+}
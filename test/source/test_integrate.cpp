@@ -0,0 +1,99 @@
+#include <doctest/doctest.h>  // for Approx, ResultBuilder, TestCase
+
+#include <cmath>                         // for abs, exp
+#include <cstddef>                       // for size_t
+#include <span>                          // for span
+#include <stdexcept>                     // for runtime_error
+#include <sphere_n/cylind_n.hpp>         // for map_cylind_n
+#include <sphere_n/integrate.hpp>        // for integrate, IntegrateOptions, CompensatedSum
+#include <sphere_n/radical_inverse.hpp>  // for radical_inverse
+#include <vector>                        // for vector
+
+TEST_CASE("CompensatedSum") {
+    auto sum = lds2::CompensatedSum{};
+    for (const auto x : {1.0, 1e100, 1.0, -1e100}) {
+        sum.add(x);
+    }
+    CHECK_EQ(sum.value(), 2.0);
+
+    auto other = lds2::CompensatedSum{};
+    for (auto i = 0; i != 10; ++i) {
+        other.add(0.1);
+    }
+    sum.merge(other);
+    CHECK_EQ(sum.value(), doctest::Approx(3.0).epsilon(1e-15));
+}
+
+TEST_CASE("integrate (mean of x_0^2 and thread independence)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    const auto f = [](std::span<const double> x) { return x[0] * x[0]; };
+    auto opts = lds2::IntegrateOptions{};
+    opts.threads = 1;
+    const auto one = lds2::integrate(f, base, 20000, opts);
+    CHECK_EQ(one.n_points, 20000U);
+    // x_0^2 averages to 1 / (m + 1) on S^m
+    CHECK_EQ(one.mean, doctest::Approx(0.2).epsilon(1e-3));
+    CHECK(one.std_error > 0.0);
+
+    opts.threads = 4;
+    const auto four = lds2::integrate(f, base, 20000, opts);
+    CHECK_EQ(four.mean, one.mean);
+    CHECK_EQ(four.std_error, one.std_error);
+
+    // the same points as map_cylind_n of the radical inverses
+    opts.mapping = lds2::Mapping::cylind;
+    const auto cyl = lds2::integrate(f, base, 4000, opts);
+    std::vector<double> u(4000 * 4);
+    for (auto k = size_t{0}; k != 4000; ++k) {
+        for (auto i = size_t{0}; i != 4; ++i) {
+            u[k * 4 + i] = lds2::radical_inverse(k + 1, base[i]);
+        }
+    }
+    std::vector<double> x(4000 * 5);
+    lds2::map_cylind_n(4, u, x);
+    auto expected = 0.0;
+    for (auto k = size_t{0}; k != 4000; ++k) {
+        expected += f(std::span<const double>(x).subspan(k * 5, 5));
+    }
+    CHECK_EQ(cyl.mean, doctest::Approx(expected / 4000.0).epsilon(1e-12));
+}
+
+TEST_CASE("integrate (running estimates and early stop)") {
+    const unsigned long base[] = {2, 3, 5};
+    const auto f = [](std::span<const double> x) { return std::exp(x[3]); };
+    auto opts = lds2::IntegrateOptions{};
+    opts.threads = 3;
+    opts.report_every = 1000;
+    opts.block_points = 100;
+
+    std::vector<lds2::Estimate> seen;
+    const auto record = [&seen](const lds2::Estimate& est) {
+        seen.push_back(est);
+        return seen.size() < 3;
+    };
+    const auto stopped = lds2::integrate(f, base, 1000000, opts, record);
+    CHECK_EQ(seen.size(), 3U);
+    CHECK_EQ(stopped.n_points, 3000U);
+    CHECK_EQ(seen[0].n_points, 1000U);
+    CHECK(seen[0].change > 1e300);
+    CHECK_EQ(seen[2].change, std::abs(seen[2].mean - seen[1].mean));
+
+    // the mean of exp(w) over S^3 is 2 I_1(1) = 1.1303182079849700...
+    opts.rel_tol = 1e-4;
+    const auto converged = lds2::integrate(f, base, 1000000, opts);
+    CHECK(converged.converged);
+    CHECK(converged.n_points < 1000000U);
+    CHECK_EQ(converged.mean, doctest::Approx(1.1303182079849700).epsilon(1e-3));
+}
+
+TEST_CASE("integrate (exception in the integrand)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    const auto f = [](std::span<const double> x) -> double {
+        if (x[4] > 0.9) throw std::runtime_error("out of domain");
+        return x[0];
+    };
+    auto opts = lds2::IntegrateOptions{};
+    opts.threads = 4;
+    opts.block_points = 64;
+    CHECK_THROWS_AS(lds2::integrate(f, base, 20000, opts), std::runtime_error);
+}
@@ -1,8 +1,19 @@
 #include <doctest/doctest.h>  // for Approx, ResultBuilder, TestCase
 
-#include <sphere_n/cylind_n.hpp>  // for cylin_n, halton_n, sphere3, sphere_n
-#include <sphere_n/sphere_n.hpp>  // for cylin_n, halton_n, sphere3, sphere_n
-#include <vector>                 // for vector
+#include <algorithm>                     // for equal, sort
+#include <array>                         // for array
+#include <cmath>                         // for abs
+#include <cstddef>                       // for byte, size_t
+#include <memory_resource>               // for monotonic_buffer_resource
+#include <numbers>                       // for pi
+#include <iterator>                      // for size
+#include <span>                          // for span
+#include <sphere_n/cylind_n.hpp>         // for cylin_n, halton_n, sphere3, sphere_n
+#include <sphere_n/halton_n.hpp>         // for HaltonN
+#include <sphere_n/radical_inverse.hpp>  // for radical_inverse, cell_ids
+#include <sphere_n/sphere_n.hpp>         // for cylin_n, halton_n, sphere3, sphere_n, tp_inverse
+#include <stdexcept>                     // for invalid_argument
+#include <vector>                        // for vector
 
 TEST_CASE("Sphere3") {
     const unsigned long base[] = {2, 3, 5};
@@ -14,12 +25,53 @@ TEST_CASE("Sphere3") {
     CHECK_EQ(res[3], doctest::Approx(6.123233995736766e-17));
 }
 
-// TEST_CASE("HaltonN") {
-//     const size_t base[] = {2, 3, 5, 7};
-//     auto hgen = lds2::HaltonN(base);
-//     const auto res = hgen.pop();
-//     CHECK_EQ(res[0], doctest::Approx(0.5));
-// }
+TEST_CASE("HaltonN") {
+    const size_t base[] = {2, 3, 5, 7};
+    auto hgen = lds2::HaltonN(base);
+    const auto res = hgen.pop();
+    CHECK_EQ(res[0], doctest::Approx(0.5));
+    CHECK_EQ(res[1], doctest::Approx(1.0 / 3.0));
+    CHECK_EQ(res[3], doctest::Approx(1.0 / 7.0));
+}
+
+TEST_CASE("HaltonN (batch, SoA, skip-ahead)") {
+    auto hgen = lds2::HaltonN(11);  // first 11 primes, more than one lane block
+    CHECK_EQ(hgen.size(), 11U);
+    constexpr auto count = 37U;
+    std::vector<double> batch(count * 11);
+    auto hgen_batch = hgen.clone();
+    hgen_batch.pop_batch(batch);
+    std::vector<double> soa(count * 11);
+    auto hgen_soa = hgen.clone();
+    hgen_soa.pop_soa(soa);
+    for (auto k = 0U; k != count; ++k) {
+        const auto res = hgen.pop();
+        for (auto d = 0U; d != 11U; ++d) {
+            CHECK_EQ(res[d], lds2::radical_inverse(k + 1, lds2::PRIME_TABLE[d]));
+            CHECK_EQ(batch[k * 11 + d], res[d]);
+            CHECK_EQ(soa[d * count + k], res[d]);
+        }
+    }
+    CHECK_EQ(hgen_batch.state().index, hgen.state().index);
+    CHECK_EQ(hgen_soa.state().index, hgen.state().index);
+
+    auto hgen_skip = lds2::HaltonN(11);
+    hgen_skip.skip(1000000);
+    std::vector<double> res(11);
+    hgen_skip.pop_into(res);
+    std::vector<double> expected(11);
+    hgen.point(1000001, expected);
+    for (auto d = 0U; d != 11U; ++d) {
+        CHECK_EQ(res[d], expected[d]);
+        CHECK_EQ(res[d], lds2::radical_inverse(1000001, lds2::PRIME_TABLE[d]));
+    }
+
+    const auto n_primes = std::size(lds2::PRIME_TABLE);
+    CHECK_EQ(lds2::HaltonN(n_primes).size(), n_primes);
+    CHECK_THROWS_AS(lds2::HaltonN{n_primes + 1}, std::invalid_argument);
+    CHECK_THROWS_AS(lds2::HaltonN{size_t{0}}, std::invalid_argument);
+    CHECK_THROWS_AS(lds2::HaltonN{std::span<const unsigned long>{}}, std::invalid_argument);
+}
 
 TEST_CASE("CylindN") {
     const unsigned long base[] = {2, 3, 5, 7};
@@ -34,3 +86,206 @@ TEST_CASE("SphereN") {
     const auto res = spgen.pop();
     CHECK_EQ(res[1], doctest::Approx(0.320904));
 }
+
+TEST_CASE("SphereN (pmr)") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    std::array<std::byte, 1024> buffer{};
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+                                              std::pmr::null_memory_resource());
+    auto spgen = lds2::SphereN(base, &arena);
+    CHECK_EQ(spgen.get_allocator().resource(), &arena);
+    const auto res = spgen.pop(&arena);
+    CHECK_EQ(res.size(), 6U);
+    CHECK_EQ(res[1], doctest::Approx(0.320904));
+}
+
+TEST_CASE("CylindN (pmr)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    std::array<std::byte, 1024> buffer{};
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+                                              std::pmr::null_memory_resource());
+    auto cygen = lds2::CylindN(base, &arena);
+    auto res = std::vector<double>(cygen.size());
+    cygen.pop_into(res);
+    CHECK_EQ(res[1], doctest::Approx(0.5896942325));
+}
+
+TEST_CASE("map_sphere_n") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    auto spgen = lds2::SphereN(base);
+    std::vector<double> u(2 * 5);
+    for (auto k = 1U; k <= 2U; ++k) {
+        for (auto i = 0U; i != 5U; ++i) {
+            u[(k - 1) * 5 + i] = lds2::radical_inverse(k, base[i]);
+        }
+    }
+    std::vector<double> res(2 * 6);
+    lds2::map_sphere_n(5, u, res);
+    for (auto k = 0U; k != 2U; ++k) {
+        const auto expected = spgen.pop();
+        for (auto j = 0U; j != 6U; ++j) {
+            CHECK_EQ(res[k * 6 + j], doctest::Approx(expected[j]));
+        }
+    }
+}
+
+TEST_CASE("map_cylind_n") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    auto cygen = lds2::CylindN(base);
+    cygen.reseed(8);
+    std::vector<double> u(4);
+    for (auto i = 0U; i != 4U; ++i) {
+        u[i] = lds2::radical_inverse(9, base[i]);
+    }
+    std::vector<double> res(5);
+    lds2::map_cylind_n(4, u, res);
+    const auto expected = cygen.pop();
+    for (auto j = 0U; j != 5U; ++j) {
+        CHECK_EQ(res[j], doctest::Approx(expected[j]));
+    }
+}
+
+TEST_CASE("map_points") {
+    std::vector<double> u(3 * 4);
+    lds2::HaltonN(4).pop_batch(u);
+    std::vector<double> res(3 * 5);
+    std::vector<double> expected(3 * 5);
+    lds2::map_points(lds2::Mapping::sphere, 4, u, res, lds2::Inversion::newton);
+    lds2::map_sphere_n(4, u, expected, lds2::Inversion::newton);
+    CHECK_EQ(res, expected);
+    lds2::map_points(lds2::Mapping::cylind, 4, u, res);
+    lds2::map_cylind_n(4, u, expected);
+    CHECK_EQ(res, expected);
+
+    // S^2 of `Mapping::sphere` is the cylindrical map
+    const auto u2 = std::span<const double>(u).first(3 * 2);
+    const auto res2 = std::span<double>(res).first(3 * 3);
+    const auto expected2 = std::span<double>(expected).first(3 * 3);
+    lds2::map_points(lds2::Mapping::sphere, 2, u2, res2, lds2::Inversion::interp,
+                     lds2::Accuracy::fast);
+    lds2::map_cylind_n(2, u2, expected2, lds2::Accuracy::fast);
+    CHECK(std::equal(res2.begin(), res2.end(), expected2.begin()));
+}
+
+TEST_CASE("inverse_sphere_n and inverse_cylind_n (round trip)") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    constexpr auto count = 500U;
+    std::vector<double> u(count * 5);
+    for (auto k = 0U; k != count; ++k) {
+        for (auto i = 0U; i != 5U; ++i) {
+            u[k * 5 + i] = lds2::radical_inverse(k + 1, base[i]);
+        }
+    }
+    std::vector<double> x(count * 6);
+    std::vector<double> back(count * 5);
+    for (const auto mode : {lds2::Inversion::interp, lds2::Inversion::newton}) {
+        lds2::map_sphere_n(5, u, x, mode);
+        lds2::inverse_sphere_n(5, x, back, mode);
+        for (auto j = 0U; j != u.size(); ++j) {
+            CHECK_LE(std::abs(back[j] - u[j]), 1e-12);
+        }
+    }
+    lds2::map_cylind_n(5, u, x);
+    lds2::inverse_cylind_n(5, x, back);
+    for (auto j = 0U; j != u.size(); ++j) {
+        CHECK_LE(std::abs(back[j] - u[j]), 1e-12);
+    }
+
+    // only the direction matters
+    for (auto& xj : x) {
+        xj *= 3.0;
+    }
+    lds2::inverse_cylind_n(5, x, back);
+    CHECK_LE(std::abs(back[7] - u[7]), 1e-12);
+}
+
+TEST_CASE("cell_ids") {
+    // 2 * 3 * 5 * 7 consecutive points of the sequence fill every elementary cell once
+    const unsigned long base[] = {2, 3, 5, 7};
+    constexpr auto count = 210U;
+    std::vector<double> u(count * 4);
+    for (auto k = 0U; k != count; ++k) {
+        for (auto i = 0U; i != 4U; ++i) {
+            u[k * 4 + i] = lds2::radical_inverse(k + 100, base[i]);
+        }
+    }
+    std::vector<unsigned long> ids(count);
+    lds2::cell_ids(u, base, ids);
+    std::ranges::sort(ids);
+    for (auto k = 0UL; k != count; ++k) {
+        CHECK_EQ(ids[k], k);
+    }
+
+    const double corners[] = {0.0, 1.0, 0.999, 0.5};
+    const unsigned long strata[] = {4, 3};
+    unsigned long res[2];
+    lds2::cell_ids(corners, strata, res);
+    CHECK_EQ(res[0], 2UL);   // (0, 2): u == 1 stays in the last interval
+    CHECK_EQ(res[1], 10UL);  // (3, 1)
+}
+
+TEST_CASE("tp_inverse (newton)") {
+    const double us[] = {1e-9, 0.001, 0.1, 0.25, 0.5, 0.73, 0.999, 1.0 - 1e-9};
+    for (const auto n : {size_t{1}, size_t{2}, size_t{3}, size_t{4}, size_t{7}, size_t{16}}) {
+        const auto t0 = lds2::tp_value(n, 0.0);
+        const auto dt = lds2::tp_value(n, std::numbers::pi) - t0;
+        for (const auto u : us) {
+            const auto xi = lds2::tp_inverse(n, u, lds2::Inversion::newton);
+            CHECK_LE(std::abs((lds2::tp_value(n, xi) - t0) / dt - u), 1e-13);
+            // the interpolated angle is off by less than one table step
+            CHECK_LE(std::abs(xi - lds2::tp_inverse(n, u)),
+                     std::numbers::pi / static_cast<double>(lds2::N_POINTS - 1));
+        }
+    }
+}
+
+TEST_CASE("SphereN (newton)") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    auto sgen = lds2::SphereN(base);
+    auto sgen_newton = lds2::SphereN(base);
+    sgen_newton.set_inversion(lds2::Inversion::newton);
+    for (auto k = 0U; k != 50U; ++k) {
+        const auto expected = sgen.pop();
+        const auto res = sgen_newton.pop();
+        auto norm2 = 0.0;
+        for (auto j = 0U; j != res.size(); ++j) {
+            CHECK_EQ(res[j], doctest::Approx(expected[j]).epsilon(1e-4));
+            norm2 += res[j] * res[j];
+        }
+        CHECK_EQ(norm2, doctest::Approx(1.0).epsilon(1e-14));
+    }
+}
+
+TEST_CASE("SphereN (nested levels)") {
+    const unsigned long base[] = {2, 3, 5, 7, 11, 13};
+    const auto bases = std::span<const unsigned long>(base);
+    auto sgen = lds2::SphereN(bases);
+    REQUIRE_EQ(sgen.levels(), 5U);
+    auto s6 = lds2::SphereN(bases);
+    auto s5 = lds2::SphereN(bases.last(5));
+    auto s4 = lds2::SphereN(bases.last(4));
+    auto s3 = lds2::Sphere3(bases.last(3));
+    auto s2 = lds2::Sphere(base[4], base[5]);
+
+    std::vector<std::vector<double>> levels;
+    std::vector<std::span<double>> views;
+    for (auto j = size_t{0}; j != sgen.levels(); ++j) {
+        levels.emplace_back(j + 3);
+    }
+    for (auto& level : levels) {
+        views.emplace_back(level);
+    }
+    for (auto k = 0U; k != 20U; ++k) {
+        sgen.pop_nested(views);
+        const auto p2 = s2.pop();
+        const auto p3 = s3.pop();
+        const auto p4 = s4.pop();
+        const auto p5 = s5.pop();
+        const auto p6 = s6.pop();
+        CHECK(std::equal(p2.begin(), p2.end(), levels[0].begin()));
+        CHECK(std::equal(p3.begin(), p3.end(), levels[1].begin()));
+        CHECK(std::equal(p4.begin(), p4.end(), levels[2].begin()));
+        CHECK(std::equal(p5.begin(), p5.end(), levels[3].begin()));
+        CHECK(std::equal(p6.begin(), p6.end(), levels[4].begin()));
+    }
+}
@@ -0,0 +1,97 @@
+#include <doctest/doctest.h>  // for Approx, ResultBuilder, TestCase
+
+#include <algorithm>               // for equal
+#include <cstddef>                 // for size_t
+#include <sphere_n/cylind_n.hpp>   // for map_cylind_n
+#include <sphere_n/halton_n.hpp>   // for HaltonN
+#include <sphere_n/numa.hpp>       // for generate_bulk, BulkOptions, numa_topology
+#include <sphere_n/sphere_n.hpp>   // for SphereN, Sphere3, Sphere, map_sphere_n, TpTables
+#include <vector>                  // for vector
+
+TEST_CASE("parse_cpu_list") {
+    const auto expected = std::vector<int>{0, 1, 2, 3, 8, 9, 12};
+    CHECK_EQ(lds2::parse_cpu_list("0-3,8-9,12\n"), expected);
+    CHECK_EQ(lds2::parse_cpu_list("5"), std::vector<int>(1, 5));
+    CHECK(lds2::parse_cpu_list("").empty());
+    CHECK(lds2::parse_cpu_list("3-1").empty());
+    CHECK(lds2::parse_cpu_list("0;1").empty());
+
+    const auto nodes = lds2::numa_topology();
+    REQUIRE(!nodes.empty());
+    for (const auto& node : nodes) {
+        CHECK(!node.cpus.empty());
+    }
+}
+
+TEST_CASE("map_sphere_n (table replica)") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    std::vector<double> u(100 * 5);
+    auto halton = lds2::HaltonN(base);
+    halton.pop_batch(u);
+    std::vector<double> shared(100 * 6);
+    std::vector<double> copied(100 * 6);
+    const auto tables = lds2::TpTables(5);
+    lds2::map_sphere_n(5, u, shared);
+    lds2::map_sphere_n(5, u, copied, tables);
+    CHECK_EQ(copied, shared);
+}
+
+TEST_CASE("generate_bulk (same points as SphereN for any threading)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    auto gen = lds2::SphereN(base);
+    auto opts = lds2::BulkOptions{};
+    opts.threads = 3;
+    const auto aware = lds2::generate_bulk(base, 1000, opts);
+    opts.numa_aware = false;
+    const auto naive = lds2::generate_bulk(base, 1000, opts);
+    REQUIRE_EQ(aware.size(), 1000U);
+    REQUIRE_EQ(aware.dim(), 5U);
+    for (auto k = size_t{0}; k != 1000; ++k) {
+        const auto x = gen.pop();
+        for (auto i = size_t{0}; i != 5; ++i) {
+            CHECK_EQ(aware.point(k)[i], doctest::Approx(x[i]).epsilon(1e-12));
+        }
+    }
+    CHECK(std::equal(aware.points().begin(), aware.points().end(), naive.points().begin()));
+
+    // the node slices cover the points in order
+    auto next = size_t{0};
+    for (const auto& slice : aware.slices()) {
+        CHECK_EQ(slice.first, next);
+        next += slice.count;
+    }
+    CHECK_EQ(next, 1000U);
+
+    // S^2 and S^3, and more threads than points
+    const unsigned long base2[] = {2, 3};
+    auto sphere = lds2::Sphere(base2[0], base2[1]);
+    opts.threads = 8;
+    const auto s2 = lds2::generate_bulk(base2, 5, opts);
+    for (auto k = size_t{0}; k != 5; ++k) {
+        const auto x = sphere.pop();
+        CHECK_EQ(s2.point(k)[2], doctest::Approx(x[2]).epsilon(1e-12));
+    }
+    const unsigned long base3[] = {2, 3, 5};
+    auto sphere3 = lds2::Sphere3(base3);
+    opts.numa_aware = true;
+    const auto s3 = lds2::generate_bulk(base3, 5, opts);
+    for (auto k = size_t{0}; k != 5; ++k) {
+        const auto x = sphere3.pop();
+        CHECK_EQ(s3.point(k)[0], doctest::Approx(x[0]).epsilon(1e-12));
+        CHECK_EQ(s3.point(k)[3], doctest::Approx(x[3]).epsilon(1e-12));
+    }
+}
+
+TEST_CASE("generate_bulk (accuracy of S^2)") {
+    const unsigned long base[] = {2, 3};
+    auto opts = lds2::BulkOptions{};
+    opts.threads = 2;
+    opts.accuracy = lds2::Accuracy::fast;
+    const auto bulk = lds2::generate_bulk(base, 300, opts);
+    std::vector<double> u(300 * 2);
+    auto halton = lds2::HaltonN(base);
+    halton.pop_batch(u);
+    std::vector<double> x(300 * 3);
+    lds2::map_cylind_n(2, u, x, lds2::Accuracy::fast);
+    CHECK(std::equal(x.begin(), x.end(), bulk.points().begin()));
+}
@@ -0,0 +1,132 @@
+#include <doctest/doctest.h>  // for ResultBuilder, TestCase, CHECK_EQ
+
+#include <cstddef>                  // for size_t
+#include <fcntl.h>                  // for O_CREAT, O_EXCL, O_RDWR
+#include <span>                     // for span
+#include <sphere_n/point_ring.hpp>  // for PointRing, PointBlock
+#include <sphere_n/sphere_n.hpp>    // for SphereN
+#include <stdexcept>                // for runtime_error, invalid_argument
+#include <string>                   // for string, to_string
+#include <sys/mman.h>               // for shm_open, shm_unlink
+#include <thread>                   // for thread
+#include <unistd.h>                 // for getpid, close
+#include <vector>                   // for vector
+
+TEST_CASE("PointRing (local, one producer, three consumers)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    constexpr size_t N_BLOCKS = 200;
+    constexpr size_t BLOCK_POINTS = 16;
+    constexpr size_t DIM = 5;
+
+    auto ring = lds2::PointRing::create_local(DIM, BLOCK_POINTS, 4);
+    CHECK_EQ(ring.dim(), DIM);
+    CHECK_EQ(ring.block_points(), BLOCK_POINTS);
+    CHECK_EQ(ring.slots(), 4U);
+
+    // each consumer copies its blocks out; checked on the main thread
+    std::vector<std::vector<double>> seen(N_BLOCKS);
+    std::vector<unsigned long> firsts(N_BLOCKS);
+    std::vector<int> claims(N_BLOCKS, 0);
+    std::vector<std::thread> consumers;
+    for (auto t = 0; t != 3; ++t) {
+        consumers.emplace_back([&ring, &seen, &firsts, &claims] {
+            auto block = lds2::PointBlock{};
+            while (ring.claim(block)) {
+                const auto pts = block.points();
+                seen[block.index()].assign(pts.begin(), pts.end());
+                firsts[block.index()] = block.first_index();
+                ++claims[block.index()];
+            }
+        });
+    }
+
+    auto gen = lds2::SphereN(base);
+    for (auto i = size_t{0}; i != N_BLOCKS; ++i) {
+        ring.produce(gen);
+    }
+    ring.close();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    auto ref = lds2::SphereN(base);
+    for (auto i = size_t{0}; i != N_BLOCKS; ++i) {
+        REQUIRE_EQ(claims[i], 1);
+        CHECK_EQ(firsts[i], i * BLOCK_POINTS + 1);
+        for (auto p = size_t{0}; p != BLOCK_POINTS; ++p) {
+            const auto pt = ref.pop();
+            for (auto d = size_t{0}; d != DIM; ++d) {
+                CHECK_EQ(seen[i][p * DIM + d], pt[d]);
+            }
+        }
+    }
+}
+
+TEST_CASE("PointRing (closed and drained)") {
+    auto ring = lds2::PointRing::create_local(3, 2, 2);
+    auto buf = ring.begin_block();
+    for (auto& v : buf) {
+        v = 1.0;
+    }
+    ring.commit_block(7);
+    ring.close();
+    auto block = lds2::PointBlock{};
+    REQUIRE(ring.claim(block));
+    CHECK_EQ(block.first_index(), 7U);
+    CHECK_EQ(block.points().size(), 6U);
+    CHECK_EQ(block.points()[5], 1.0);
+    block.release();
+    CHECK_FALSE(ring.claim(block));
+    CHECK_FALSE(ring.claim(block));
+}
+
+TEST_CASE("PointRing (geometry)") {
+    // a single slot cannot tell a published block from a free slot
+    CHECK_THROWS_AS(lds2::PointRing::create_local(5, 8, 1), std::invalid_argument);
+    CHECK_THROWS_AS(lds2::PointRing::create_local(5, 8, 0), std::invalid_argument);
+    CHECK_THROWS_AS(lds2::PointRing::create_local(0, 8, 2), std::invalid_argument);
+    CHECK_THROWS_AS(lds2::PointRing::create_local(5, 0, 2), std::invalid_argument);
+    CHECK_NOTHROW(lds2::PointRing::create_local(5, 8, 2));
+}
+
+#if SPHERE_N_HAS_SHM
+TEST_CASE("PointRing (shared memory)") {
+    const auto name = "/sphere_n_test_" + std::to_string(::getpid());
+    auto server = lds2::PointRing::create_shared(name, 5, 8, 2);
+    CHECK_THROWS_AS(lds2::PointRing::create_shared(name, 5, 8, 2), std::runtime_error);
+
+    auto client = lds2::PointRing::open_shared(name);
+    CHECK_EQ(client.dim(), 5U);
+    CHECK_EQ(client.block_points(), 8U);
+    CHECK_EQ(client.slots(), 2U);
+
+    const unsigned long base[] = {2, 3, 5, 7};
+    auto gen = lds2::SphereN(base);
+    auto ref = gen.clone();
+    server.produce(gen);
+    server.produce(gen);
+    server.close();
+
+    auto block = lds2::PointBlock{};
+    for (auto i = 0U; i != 2U; ++i) {
+        REQUIRE(client.claim(block));
+        CHECK_EQ(block.index(), i);
+        for (auto p = 0U; p != 8U; ++p) {
+            const auto pt = ref.pop();
+            CHECK_EQ(block.points()[p * 5 + 2], pt[2]);
+        }
+    }
+    CHECK_FALSE(client.claim(block));
+    CHECK_THROWS_AS(lds2::PointRing::open_shared(name + "_missing"), std::runtime_error);
+}
+
+TEST_CASE("PointRing (shared memory, creator not done)") {
+    // an object that create_shared() has opened but not yet sized
+    const auto name = "/sphere_n_test_empty_" + std::to_string(::getpid());
+    const auto fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    REQUIRE(fd >= 0);
+    CHECK_THROWS_AS(lds2::PointRing::open_shared(name), std::runtime_error);
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+}
+#endif
@@ -0,0 +1,79 @@
+#include <doctest/doctest.h>  // for Approx, ResultBuilder, TestCase
+
+#include <cstddef>                // for size_t
+#include <span>                   // for span
+#include <sphere_n/cylind_n.hpp>  // for CylindN, map_cylind_n
+#include <sphere_n/halton_n.hpp>  // for HaltonN
+#include <sphere_n/prefetch.hpp>  // for Prefetcher, PrefetchOptions, WaitPolicy
+#include <sphere_n/sphere_n.hpp>  // for SphereN
+#include <stdexcept>              // for invalid_argument
+#include <vector>                 // for vector
+
+TEST_CASE("Prefetcher (same points as SphereN, any depth and wait policy)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    for (const auto wait : {lds2::WaitPolicy::yield, lds2::WaitPolicy::park}) {
+        auto opts = lds2::PrefetchOptions{};
+        opts.depth = 2;
+        opts.block_points = 7;
+        opts.wait = wait;
+        auto pre = lds2::Prefetcher(base, opts);
+        auto gen = lds2::SphereN(base);
+        REQUIRE_EQ(pre.dim(), 5U);
+        std::vector<double> x(5);
+        for (auto k = 0; k != 500; ++k) {
+            pre.next_into(x);
+            const auto ref = gen.pop();
+            for (auto i = size_t{0}; i != 5; ++i) {
+                CHECK_EQ(x[i], doctest::Approx(ref[i]).epsilon(1e-12));
+            }
+        }
+    }
+    auto opts = lds2::PrefetchOptions{};
+    opts.depth = 0;
+    CHECK_THROWS_AS(lds2::Prefetcher(base, opts), std::invalid_argument);
+}
+
+TEST_CASE("Prefetcher (reseed drops the points generated ahead)") {
+    const unsigned long base[] = {2, 3, 5};
+    auto opts = lds2::PrefetchOptions{};
+    opts.depth = 4;
+    opts.block_points = 16;
+    opts.mapping = lds2::Mapping::cylind;
+    auto pre = lds2::Prefetcher(base, opts);
+    auto gen = lds2::CylindN(base);
+    for (const auto seed : {0UL, 1000UL, 3UL, 3UL, 77777UL}) {
+        for (auto k = 0; k != 5; ++k) {
+            pre.next();
+        }
+        pre.reseed(seed);
+        gen.reseed(seed);
+        for (auto k = 0; k != 40; ++k) {
+            const auto x = pre.next();
+            const auto ref = gen.pop();
+            for (auto i = size_t{0}; i != 4; ++i) {
+                CHECK_EQ(x[i], doctest::Approx(ref[i]).epsilon(1e-12));
+            }
+        }
+    }
+    // destroyed while the producer is blocked on a full ring
+}
+
+TEST_CASE("Prefetcher (accuracy of the cylindrical map)") {
+    const unsigned long base[] = {2, 3, 5};
+    auto opts = lds2::PrefetchOptions{};
+    opts.block_points = 32;
+    opts.mapping = lds2::Mapping::cylind;
+    opts.accuracy = lds2::Accuracy::fast;
+    auto pre = lds2::Prefetcher(base, opts);
+    std::vector<double> u(32 * 3);
+    auto halton = lds2::HaltonN(base);
+    halton.pop_batch(u);
+    std::vector<double> ref(32 * 4);
+    lds2::map_cylind_n(3, u, ref, lds2::Accuracy::fast);
+    for (auto k = size_t{0}; k != 32; ++k) {
+        const auto x = pre.next();
+        for (auto i = size_t{0}; i != 4; ++i) {
+            CHECK_EQ(x[i], ref[k * 4 + i]);
+        }
+    }
+}
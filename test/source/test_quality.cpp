@@ -0,0 +1,111 @@
+#include <doctest/doctest.h>  // for Approx, ResultBuilder, TestCase
+
+#include <algorithm>              // for min
+#include <cmath>                  // for sqrt, pow, log
+#include <cstddef>                // for size_t
+#include <span>                   // for span
+#include <sphere_n/cylind_n.hpp>  // for CylindN
+#include <sphere_n/quality.hpp>   // for min_distance, riesz_energy, ...
+#include <sphere_n/sphere_n.hpp>  // for SphereN
+#include <vector>                 // for vector
+
+/**
+ * @brief The first n points of a generator, row-major
+ */
+template <typename Gen> static auto take_points(Gen& gen, size_t n) -> std::vector<double> {
+    std::vector<double> res(n * gen.size());
+    for (auto i = size_t{0}; i != n; ++i) {
+        gen.pop_into(std::span<double>(res).subspan(i * gen.size(), gen.size()));
+    }
+    return res;
+}
+
+/**
+ * @brief Squared distance between points i and j
+ */
+static auto dist2(const std::vector<double>& pts, size_t dim, size_t i, size_t j) -> double {
+    auto res = 0.0;
+    for (auto d = size_t{0}; d != dim; ++d) {
+        const auto diff = pts[i * dim + d] - pts[j * dim + d];
+        res += diff * diff;
+    }
+    return res;
+}
+
+TEST_CASE("quality metrics (brute force)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    auto sgen = lds2::SphereN(base);
+    const auto pts = take_points(sgen, 500);
+    const auto dim = size_t{5};
+    const auto n = pts.size() / dim;
+
+    auto dmin2 = 1e300;
+    auto e1 = 0.0;
+    auto e2 = 0.0;
+    auto e15 = 0.0;
+    auto elog = 0.0;
+    for (auto i = size_t{0}; i != n; ++i) {
+        for (auto j = i + 1; j != n; ++j) {
+            const auto r2 = dist2(pts, dim, i, j);
+            dmin2 = std::min(dmin2, r2);
+            e1 += 1.0 / std::sqrt(r2);
+            e2 += 1.0 / r2;
+            e15 += std::pow(r2, -0.75);
+            elog -= 0.5 * std::log(r2);
+        }
+    }
+
+    auto opts = lds2::QualityOptions{};
+    opts.threads = 3;
+    CHECK_EQ(lds2::min_distance(pts, dim, opts), doctest::Approx(std::sqrt(dmin2)));
+    CHECK_EQ(lds2::riesz_energy(pts, dim, opts), doctest::Approx(e1));
+    opts.riesz_s = 2.0;
+    CHECK_EQ(lds2::riesz_energy(pts, dim, opts), doctest::Approx(e2));
+    opts.riesz_s = 1.5;
+    CHECK_EQ(lds2::riesz_energy(pts, dim, opts), doctest::Approx(e15));
+    opts.riesz_s = 0.0;
+    CHECK_EQ(lds2::riesz_energy(pts, dim, opts), doctest::Approx(elog));
+}
+
+TEST_CASE("quality metrics (independent of the thread count)") {
+    const unsigned long base[] = {2, 3, 5};
+    auto cgen = lds2::CylindN(base);
+    const auto pts = take_points(cgen, 2000);
+    auto opts = lds2::QualityOptions{};
+    opts.n_caps = 16;
+    opts.n_probes = 512;
+    opts.threads = 1;
+    const auto one = lds2::measure_quality(pts, 4, opts);
+    opts.threads = 4;
+    const auto four = lds2::measure_quality(pts, 4, opts);
+    CHECK_EQ(one.cap_discrepancy, four.cap_discrepancy);
+    CHECK_EQ(one.riesz_energy, four.riesz_energy);
+    CHECK_EQ(one.min_distance, four.min_distance);
+    CHECK_EQ(one.covering_radius, four.covering_radius);
+    CHECK_EQ(one.min_distance, lds2::min_distance(pts, 4, opts));
+    CHECK(one.cap_discrepancy < 0.05);
+    CHECK(one.covering_radius > 0.5 * one.min_distance);
+}
+
+TEST_CASE("quality metrics (octahedron and circle)") {
+    const std::vector<double> octa = {1, 0, 0, -1, 0, 0, 0, 1, 0, 0, -1, 0, 0, 0, 1, 0, 0, -1};
+    auto opts = lds2::QualityOptions{};
+    opts.n_probes = 20000;
+    CHECK_EQ(lds2::min_distance(octa, 3, opts), doctest::Approx(std::sqrt(2.0)));
+    // the face centers are the farthest points: |(1,1,1)/sqrt(3) - (1,0,0)|
+    const auto cover = std::sqrt(2.0 - 2.0 / std::sqrt(3.0));
+    CHECK_LE(lds2::covering_radius(octa, 3, opts), cover + 1e-12);
+    CHECK(lds2::covering_radius(octa, 3, opts) > cover - 0.02);
+
+    // n equally spaced points on the circle: every cap holds its share up to one point
+    const auto n = size_t{360};
+    std::vector<double> circle(2 * n);
+    for (auto i = size_t{0}; i != n; ++i) {
+        const auto phi = 2.0 * 3.14159265358979323846 * static_cast<double>(i) / 360.0;
+        circle[2 * i] = std::cos(phi);
+        circle[2 * i + 1] = std::sin(phi);
+    }
+    const auto disc = lds2::cap_discrepancy(circle, 2, opts);
+    CHECK(disc > 0.0);
+    CHECK_LE(disc, 1.0 / 360.0 + 1e-12);
+}
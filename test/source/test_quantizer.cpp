@@ -0,0 +1,60 @@
+#include <doctest/doctest.h>  // for ResultBuilder, TestCase, CHECK_EQ
+
+#include <cstddef>                 // for size_t
+#include <span>                    // for span
+#include <sphere_n/quantizer.hpp>  // for SphereQuantizer
+#include <sphere_n/sphere_n.hpp>   // for SphereN
+#include <vector>                  // for vector
+
+/**
+ * @brief Index of the codeword nearest to q, by brute force
+ */
+static auto brute_nearest(const lds2::SphereQuantizer& quant, std::span<const double> q) -> size_t {
+    auto best = size_t{0};
+    auto best_d2 = 1e300;
+    for (auto i = size_t{0}; i != quant.size(); ++i) {
+        auto d2 = 0.0;
+        for (auto d = size_t{0}; d != quant.dim(); ++d) {
+            const auto diff = quant.codeword(i)[d] - q[d];
+            d2 += diff * diff;
+        }
+        if (d2 < best_d2) {
+            best_d2 = d2;
+            best = i;
+        }
+    }
+    return best;
+}
+
+TEST_CASE("SphereQuantizer (matches brute force while growing)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    auto sgen = lds2::SphereN(base);
+    auto quant = lds2::SphereQuantizer(5);
+    CHECK_EQ(quant.nearest(std::vector<double>(5, 1.0)), 0U);  // empty: returns size()
+
+    // queries: later points of a differently based sequence, scaled
+    const unsigned long qbase[] = {3, 2, 7, 5};
+    auto qgen = lds2::SphereN(qbase);
+    std::vector<double> queries(300 * 5);
+    for (auto i = size_t{0}; i != 300; ++i) {
+        const auto pt = qgen.pop();
+        for (auto d = size_t{0}; d != 5; ++d) {
+            queries[i * 5 + d] = 2.5 * pt[d];
+        }
+    }
+    std::vector<size_t> res(300);
+    for (const auto n : {10U, 90U, 900U, 2000U}) {
+        quant.grow(sgen, n);
+        quant.nearest_batch(queries, res);
+        for (auto i = size_t{0}; i != 300; ++i) {
+            const auto query = std::span<const double>(queries).subspan(i * 5, 5);
+            CHECK_EQ(res[i], brute_nearest(quant, query));
+        }
+    }
+    CHECK_EQ(quant.size(), 3000U);
+
+    // every codeword is its own nearest codeword
+    for (auto i = size_t{0}; i < quant.size(); i += 97) {
+        CHECK_EQ(quant.nearest(quant.codeword(i)), i);
+    }
+}
@@ -0,0 +1,112 @@
+#include <doctest/doctest.h>  // for Approx, ResultBuilder, TestCase
+
+#include <algorithm>              // for clamp
+#include <cmath>                  // for acos, cos, sqrt
+#include <cstddef>                // for size_t
+#include <numbers>                // for pi
+#include <span>                   // for span
+#include <sphere_n/region.hpp>    // for RegionN, Mapping
+#include <sphere_n/sphere_n.hpp>  // for SphereN, tp_cdf
+#include <vector>                 // for vector
+
+/**
+ * @brief Angles between the rows of pts and a unit axis
+ */
+static auto angles(const std::vector<double>& pts, const std::vector<double>& axis)
+    -> std::vector<double> {
+    const auto dim = axis.size();
+    std::vector<double> res(pts.size() / dim);
+    for (auto k = size_t{0}; k != res.size(); ++k) {
+        auto dot = 0.0;
+        auto norm2 = 0.0;
+        for (auto d = size_t{0}; d != dim; ++d) {
+            dot += pts[k * dim + d] * axis[d];
+            norm2 += pts[k * dim + d] * pts[k * dim + d];
+        }
+        CHECK_EQ(norm2, doctest::Approx(1.0));
+        res[k] = std::acos(std::clamp(dot, -1.0, 1.0));
+    }
+    return res;
+}
+
+TEST_CASE("RegionN (whole sphere matches SphereN)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    const double pole[] = {0, 0, 0, 0, 1};
+    auto rgen = lds2::RegionN(base, pole, 0.0, std::numbers::pi);
+    CHECK_EQ(rgen.fraction(), 1.0);
+    auto sgen = lds2::SphereN(base);
+    for (auto k = 0U; k != 50U; ++k) {
+        const auto expected = sgen.pop();
+        const auto res = rgen.pop();
+        for (auto j = 0U; j != 5U; ++j) {
+            CHECK_EQ(res[j], doctest::Approx(expected[j]));
+        }
+    }
+}
+
+TEST_CASE("RegionN (cap around an arbitrary axis)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    std::vector<double> axis = {1, -2, 3, 0.5, 2};
+    auto norm = 0.0;
+    for (const auto a : axis) {
+        norm += a * a;
+    }
+    for (auto& a : axis) {
+        a /= std::sqrt(norm);
+    }
+    const auto theta = 0.3;
+    constexpr auto count = size_t{4096};
+    for (const auto mode : {lds2::Inversion::interp, lds2::Inversion::newton}) {
+        auto rgen = lds2::RegionN::cap(base, axis, theta);
+        rgen.set_inversion(mode);
+        CHECK_EQ(rgen.fraction(), doctest::Approx(lds2::tp_cdf(3, theta)).epsilon(1e-4));
+        std::vector<double> pts(count * 5);
+        rgen.clone().pop_batch(pts);
+        const auto first = rgen.pop();
+        for (auto j = 0U; j != 5U; ++j) {
+            CHECK_EQ(first[j], pts[j]);
+        }
+        CHECK(rgen.state().inversion == mode);
+        // inside the cap, and the inner half-angle cap holds its share
+        auto inner = 0.0;
+        for (const auto a : angles(pts, axis)) {
+            CHECK_LE(a, theta + 1e-9);
+            inner += (a <= 0.5 * theta) ? 1.0 : 0.0;
+        }
+        const auto share = lds2::tp_cdf(3, 0.5 * theta, mode) / lds2::tp_cdf(3, theta, mode);
+        CHECK_EQ(inner / static_cast<double>(count), doctest::Approx(share).epsilon(0.01));
+    }
+}
+
+TEST_CASE("RegionN (bands)") {
+    const auto lo = 1.0;
+    const auto hi = 1.4;
+    constexpr auto count = size_t{2000};
+
+    // S^2: the height above the equator of the axis is uniform (Archimedes)
+    const unsigned long base2[] = {2, 3};
+    const std::vector<double> axis2 = {0, 1, 0};
+    auto sgen = lds2::RegionN(base2, axis2, lo, hi);
+    CHECK_EQ(sgen.fraction(), doctest::Approx(0.5 * (std::cos(lo) - std::cos(hi))));
+    std::vector<double> pts2(count * 3);
+    sgen.pop_batch(pts2);
+    auto mean_cos = 0.0;
+    for (const auto a : angles(pts2, axis2)) {
+        CHECK(a >= lo - 1e-12);
+        CHECK_LE(a, hi + 1e-12);
+        mean_cos += std::cos(a);
+    }
+    CHECK_EQ(mean_cos / static_cast<double>(count),
+             doctest::Approx(0.5 * (std::cos(lo) + std::cos(hi))).epsilon(1e-3));
+
+    // CylindN mapping on S^3, with the axis at the opposite pole
+    const unsigned long base3[] = {2, 3, 5};
+    const std::vector<double> axis3 = {0, 0, 0, -1};
+    auto cgen = lds2::RegionN(base3, axis3, lo, hi, lds2::Mapping::cylind);
+    std::vector<double> pts3(count * 4);
+    cgen.pop_batch(pts3);
+    for (const auto a : angles(pts3, axis3)) {
+        CHECK(a >= lo - 1e-12);
+        CHECK_LE(a, hi + 1e-12);
+    }
+}
@@ -0,0 +1,90 @@
+#include <doctest/doctest.h>  // for Approx, ResultBuilder, TestCase
+
+#include <cmath>                   // for abs
+#include <cstddef>                 // for size_t
+#include <span>                    // for span
+#include <sphere_n/gen_state.hpp>  // for read_state, write_state
+#include <sphere_n/rotation.hpp>   // for Rotation3, quat_to_matrix, Antipodal
+#include <sphere_n/sphere_n.hpp>   // for Sphere3
+#include <sstream>                 // for stringstream
+#include <vector>                  // for vector
+
+TEST_CASE("Rotation3 (fold matches Sphere3)") {
+    const unsigned long base[] = {2, 3, 5};
+    auto sgen = lds2::Sphere3(base);
+    auto rgen = lds2::Rotation3(base, lds2::Antipodal::fold);
+    for (auto k = 0U; k != 100U; ++k) {
+        const auto p = sgen.pop();
+        const auto q = rgen.pop();
+        const auto sign = (p[3] < 0.0) ? -1.0 : 1.0;
+        for (auto j = 0U; j != 4U; ++j) {
+            CHECK_EQ(q[j], doctest::Approx(sign * p[j]));
+        }
+    }
+}
+
+TEST_CASE("Rotation3 (state keeps the antipodal method)") {
+    const unsigned long base[] = {2, 3, 5};
+    auto rgen = lds2::Rotation3(base, lds2::Antipodal::fold);
+    rgen.pop();
+    std::stringstream ss;
+    lds2::write_state(ss, rgen.state());
+    const auto state = lds2::read_state(ss);
+    CHECK(state.antipodal == lds2::Antipodal::fold);
+    auto restored = lds2::Rotation3(state);
+    CHECK_EQ(rgen.pop(), restored.pop());
+}
+
+TEST_CASE("Rotation3 (hemisphere, batches and matrices)") {
+    const unsigned long base[] = {2, 3, 5};
+    auto rgen = lds2::Rotation3(base);
+    constexpr auto count = size_t{4096};
+    std::vector<double> quat(count * 4);
+    rgen.clone().pop_batch(quat);
+    std::vector<double> mat(count * 9);
+    rgen.clone().pop_batch_matrix(mat);
+    std::vector<double> expected(count * 9);
+    lds2::quat_to_matrix(quat, expected);
+
+    auto trace = 0.0;
+    for (auto k = size_t{0}; k != count; ++k) {
+        const auto* q = &quat[k * 4];
+        CHECK(q[3] >= 0.0);
+        CHECK_EQ(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3],
+                 doctest::Approx(1.0));
+        const auto* r = &mat[k * 9];
+        for (auto j = 0U; j != 9U; ++j) {
+            CHECK_EQ(r[j], expected[k * 9 + j]);
+        }
+        // R R^T = I and det R = 1
+        for (auto a = 0U; a != 3U; ++a) {
+            for (auto b = 0U; b != 3U; ++b) {
+                const auto dot = r[3 * a] * r[3 * b] + r[3 * a + 1] * r[3 * b + 1]
+                                 + r[3 * a + 2] * r[3 * b + 2];
+                CHECK_EQ(dot, doctest::Approx(a == b ? 1.0 : 0.0));
+            }
+        }
+        const auto det = r[0] * (r[4] * r[8] - r[5] * r[7]) - r[1] * (r[3] * r[8] - r[5] * r[6])
+                         + r[2] * (r[3] * r[7] - r[4] * r[6]);
+        CHECK_EQ(det, doctest::Approx(1.0));
+        trace += r[0] + r[4] + r[8];
+    }
+    // the trace 1 + 2 cos(angle) of a Haar-random rotation has mean 0
+    CHECK_LE(std::abs(trace / static_cast<double>(count)), 0.01);
+
+    // single pops, skip-ahead and the saved state continue the same sequence
+    const auto q0 = rgen.pop();
+    const auto m1 = rgen.pop_matrix();
+    for (auto j = 0U; j != 4U; ++j) {
+        CHECK_EQ(q0[j], quat[j]);
+    }
+    for (auto j = 0U; j != 9U; ++j) {
+        CHECK_EQ(m1[j], mat[9 + j]);
+    }
+    rgen.skip(count - 3);
+    auto restored = lds2::Rotation3(rgen.state());
+    const auto q_last = restored.pop();
+    for (auto j = 0U; j != 4U; ++j) {
+        CHECK_EQ(q_last[j], quat[(count - 1) * 4 + j]);
+    }
+}
@@ -0,0 +1,55 @@
+#include <doctest/doctest.h>  // for Approx, ResultBuilder, TestCase
+
+#include <algorithm>          // for sort
+#include <cmath>              // for floor
+#include <numeric>            // for inner_product
+#include <sphere_n/rqmc.hpp>  // for RandomizedSphereN, RandomizedVdCorput
+#include <vector>             // for vector
+
+TEST_CASE("RandomizedVdCorput (stratification)") {
+    const unsigned long base[] = {2, 3};
+    auto rvdc = lds2::RandomizedVdCorput(base, 4, 42);
+    std::vector<double> u(4 * 2);
+    std::vector<std::vector<int>> cells(4);
+    for (auto k = 1U; k <= 16U; ++k) {
+        rvdc.values(k, u);
+        for (auto r = 0U; r != 4U; ++r) {
+            CHECK_GE(u[r * 2], 0.0);
+            CHECK_LT(u[r * 2], 1.0);
+            cells[r].push_back(static_cast<int>(std::floor(u[r * 2] * 16.0)));
+        }
+    }
+    for (auto& c : cells) {
+        std::sort(c.begin(), c.end());
+        for (auto i = 0; i != 16; ++i) {
+            CHECK_EQ(c[static_cast<size_t>(i)], i);
+        }
+    }
+}
+
+TEST_CASE("RandomizedSphereN") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    auto gen1 = lds2::RandomizedSphereN(base, 8, 2024);
+    auto gen2 = lds2::RandomizedSphereN(base, 8, 2024);
+    const auto res1 = gen1.pop();
+    const auto res2 = gen2.pop();
+    CHECK_EQ(res1, res2);
+    CHECK_EQ(res1.size(), 8U * 6U);
+    for (auto r = 0U; r != 8U; ++r) {
+        const auto* x = &res1[r * 6];
+        CHECK_EQ(std::inner_product(x, x + 6, x, 0.0), doctest::Approx(1.0));
+    }
+    CHECK_NE(res1[0], res1[6]);
+}
+
+TEST_CASE("RandomizedCylindN (random shift)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    auto gen = lds2::RandomizedCylindN(base, 3, 7, lds2::Randomization::random_shift);
+    gen.reseed(10);
+    const auto res = gen.pop();
+    CHECK_EQ(res.size(), 3U * 5U);
+    for (auto r = 0U; r != 3U; ++r) {
+        const auto* x = &res[r * 5];
+        CHECK_EQ(std::inner_product(x, x + 5, x, 0.0), doctest::Approx(1.0));
+    }
+}
@@ -0,0 +1,100 @@
+#include <doctest/doctest.h>  // for Approx, ResultBuilder, TestCase
+
+#include <algorithm>                     // for max
+#include <cmath>                         // for sin, cos, abs
+#include <numbers>                       // for pi
+#include <sphere_n/cylind_n.hpp>         // for map_cylind_n
+#include <sphere_n/radical_inverse.hpp>  // for radical_inverse
+#include <sphere_n/sincos.hpp>           // for sin_cos, Accuracy, sincos_max_error
+#include <sphere_n/sphere_n.hpp>         // for SphereN, map_sphere_n
+#include <vector>                        // for vector
+
+/**
+ * @brief Largest error of sin_cos() at n + 1 equally spaced points of [lo, hi]
+ */
+static auto max_sincos_error(lds2::Accuracy acc, double lo, double hi, long n) -> double {
+    auto res = 0.0;
+    for (auto i = 0L; i <= n; ++i) {
+        const auto x = lo + (hi - lo) * static_cast<double>(i) / static_cast<double>(n);
+        auto s = 0.0;
+        auto c = 0.0;
+        lds2::sin_cos(acc, x, s, c);
+        res = std::max({res, std::abs(s - std::sin(x)), std::abs(c - std::cos(x))});
+    }
+    return res;
+}
+
+TEST_CASE("sin_cos (error bound)") {
+    constexpr auto TWO_PI = 2.0 * std::numbers::pi;
+    for (const auto acc : {lds2::Accuracy::high, lds2::Accuracy::fast}) {
+        const auto bound = lds2::sincos_max_error(acc);
+        // the angles used by the generators, densely
+        CHECK_LE(max_sincos_error(acc, -TWO_PI, TWO_PI, 1L << 21), bound);
+        // the whole supported domain, at an irregular spacing
+        CHECK_LE(max_sincos_error(acc, -lds2::SINCOS_MAX_ARG, lds2::SINCOS_MAX_ARG, 1999993),
+                 bound);
+        // quadrant boundaries
+        for (auto k = -64; k <= 64; ++k) {
+            const auto x = k * std::numbers::pi / 4.0;
+            CHECK_LE(max_sincos_error(acc, x - 1e-12, x + 1e-12, 2), bound);
+        }
+    }
+}
+
+TEST_CASE("sin_cos (batch)") {
+    std::vector<double> x(100);
+    for (auto i = 0U; i != x.size(); ++i) {
+        x[i] = 0.37 * i - 10.0;
+    }
+    std::vector<double> s(x.size());
+    std::vector<double> c(x.size());
+    lds2::sin_cos(lds2::Accuracy::high, x, s, c);
+    for (auto i = 0U; i != x.size(); ++i) {
+        auto si = 0.0;
+        auto ci = 0.0;
+        lds2::sin_cos(lds2::Accuracy::high, x[i], si, ci);
+        CHECK_EQ(s[i], si);
+        CHECK_EQ(c[i], ci);
+    }
+}
+
+TEST_CASE("SphereN (accuracy)") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    auto sgen = lds2::SphereN(base);
+    auto sgen_fast = lds2::SphereN(base);
+    sgen_fast.set_accuracy(lds2::Accuracy::fast);
+    const auto bound = 3.0 * lds2::sincos_max_error(lds2::Accuracy::fast);  // three levels
+    for (auto k = 0U; k != 100U; ++k) {
+        const auto expected = sgen.pop();
+        const auto res = sgen_fast.pop();
+        for (auto j = 0U; j != res.size(); ++j) {
+            CHECK_LE(std::abs(res[j] - expected[j]), bound);
+        }
+    }
+}
+
+TEST_CASE("map_sphere_n (accuracy)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    constexpr auto count = 200U;  // more than one block
+    std::vector<double> u(count * 4);
+    for (auto k = 0U; k != count; ++k) {
+        for (auto i = 0U; i != 4U; ++i) {
+            u[k * 4 + i] = lds2::radical_inverse(k + 1, base[i]);
+        }
+    }
+    std::vector<double> expected(count * 5);
+    std::vector<double> res(count * 5);
+    lds2::map_sphere_n(4, u, expected);
+    lds2::map_sphere_n(4, u, res, lds2::Inversion::interp, lds2::Accuracy::high);
+    const auto bound = 3.0 * lds2::sincos_max_error(lds2::Accuracy::high);
+    for (auto j = 0U; j != res.size(); ++j) {
+        CHECK_LE(std::abs(res[j] - expected[j]), bound);
+    }
+    std::vector<double> expected_cyl(count * 5);
+    std::vector<double> res_cyl(count * 5);
+    lds2::map_cylind_n(4, u, expected_cyl);
+    lds2::map_cylind_n(4, u, res_cyl, lds2::Accuracy::high);
+    for (auto j = 0U; j != res_cyl.size(); ++j) {
+        CHECK_LE(std::abs(res_cyl[j] - expected_cyl[j]), bound);
+    }
+}
@@ -0,0 +1,51 @@
+#include <doctest/doctest.h>  // for ResultBuilder, TestCase
+
+#include <sphere_n/cylind_n.hpp>  // for CylindN
+#include <sphere_n/sphere_n.hpp>  // for SphereN
+#include <sphere_n/stats.hpp>     // for stats_snapshot, stats_reset, PopKind
+#include <vector>                 // for vector
+
+TEST_CASE("stats") {
+    lds2::stats_reset();
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    auto spgen = lds2::SphereN(base);
+    spgen.pop();
+    spgen.pop();
+    auto cygen = lds2::CylindN(base);
+    cygen.pop();
+    const auto stats = lds2::stats_snapshot();
+    if (stats.enabled) {
+        CHECK_EQ(stats.pops[static_cast<size_t>(lds2::PopKind::sphere_n)][5], 2U);
+        CHECK_EQ(stats.pops[static_cast<size_t>(lds2::PopKind::sphere_n)][4], 2U);
+        CHECK_EQ(stats.total_pops(lds2::PopKind::sphere3), 2U);
+        CHECK_EQ(stats.total_pops(lds2::PopKind::cylind_n), 4U);
+        CHECK_EQ(stats.tp_cache_hits + stats.tp_cache_misses, 4U);
+        CHECK_EQ(stats.interp_calls, 6U);
+    } else {
+        CHECK_EQ(stats.total_pops(lds2::PopKind::sphere_n), 0U);
+        CHECK_EQ(stats.interp_calls, 0U);
+    }
+}
+
+/** @brief Trace regions entered and currently open through the test hooks */
+static int trace_entered = 0;
+static int trace_depth = 0;
+
+TEST_CASE("stats (trace hooks)") {
+    lds2::set_trace_hooks({[](const char*) {
+                               ++trace_entered;
+                               ++trace_depth;
+                           },
+                           [](const char*) { --trace_depth; }});
+    std::vector<double> u(4, 0.5);
+    std::vector<double> res(5);
+    lds2::map_sphere_n(4, u, res);
+    lds2::set_trace_hooks({});
+    lds2::map_sphere_n(4, u, res);
+    CHECK_EQ(trace_depth, 0);
+    if (lds2::stats_snapshot().enabled) {
+        CHECK_GE(trace_entered, 1);  // map_sphere_n, plus a Tp build on first use
+    } else {
+        CHECK_EQ(trace_entered, 0);
+    }
+}
@@ -0,0 +1,52 @@
+#include <doctest/doctest.h>  // for Approx, ResultBuilder, TestCase
+
+#include <numeric>             // for inner_product
+#include <ranges>              // for take, transform, ref_view
+#include <span>                // for span
+#include <sphere_n/views.hpp>  // for sphere_n_view, cylind_n_view
+#include <vector>              // for vector
+
+static_assert(std::ranges::input_range<lds2::GeneratorView<lds2::SphereN>>);
+static_assert(std::ranges::view<lds2::GeneratorView<lds2::SphereN>>);
+
+TEST_CASE("sphere_n_view") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    auto spgen = lds2::SphereN(base);
+    auto norms = lds2::sphere_n_view(base) | std::views::take(10)
+                 | std::views::transform([&spgen](std::span<const double> pt) {
+                       CHECK_EQ(pt.size(), 6U);
+                       CHECK_EQ(pt[1], doctest::Approx(spgen.pop()[1]));
+                       return std::inner_product(pt.begin(), pt.end(), pt.begin(), 0.0);
+                   });
+    auto count = 0;
+    for (const auto norm : norms) {
+        CHECK_EQ(norm, doctest::Approx(1.0));
+        ++count;
+    }
+    CHECK_EQ(count, 10);
+}
+
+TEST_CASE("cylind_n_view (chunked)") {
+    const unsigned long base[] = {2, 3, 5, 7};
+    auto cygen = lds2::CylindN(base);
+    for (const auto chunk : lds2::cylind_n_view(base, 4) | std::views::take(3)) {
+        REQUIRE_EQ(chunk.size(), 4U * 5U);
+        for (auto i = 0U; i != 4U; ++i) {
+            CHECK_EQ(chunk[i * 5 + 1], doctest::Approx(cygen.pop()[1]));
+        }
+    }
+}
+
+TEST_CASE("sphere_n_view (take advances by n)") {
+    const unsigned long base[] = {2, 3, 5, 7, 11};
+    auto spgen = lds2::SphereN(base);
+    auto view = lds2::sphere_n_view(base);
+    auto count = 0;
+    for (const auto pt : std::ranges::ref_view(view) | std::views::take(3)) {
+        CHECK_EQ(pt[1], doctest::Approx(spgen.pop()[1]));
+        ++count;
+    }
+    CHECK_EQ(count, 3);
+    // the fourth point was not generated by take(3)
+    CHECK_EQ((*view.begin())[1], doctest::Approx(spgen.pop()[1]));
+}